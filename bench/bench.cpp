@@ -0,0 +1,281 @@
+/*
+* Poker Texas Holdem - benchmarks
+*
+* Description :
+    *-Times the hot paths of the poker engine: the deck, the hand evaluator,
+    * the hand indexer, the equity cache, side pots, interaction logging,
+    * ranking, the leaderboard and whole headless hands.
+    * Reports time and heap allocations per operation so regressions show up
+    * before they reach the tables.
+    *
+     */
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+#include "poker/alloc_hook.h"
+#include "poker/engine.h"
+
+using namespace std;
+using namespace poker;
+
+// Struct for the result of one benchmark
+struct BenchmarkResult {
+    long long iterations = 0;
+    double nsPerOp = 0;
+    double allocsPerOp = 0;
+};
+
+// Sink for benchmark results, so the compiler cannot drop the work being timed
+volatile long long benchmarkSink = 0;
+
+// Function to time a piece of work
+//
+// Calls the work in batches, doubling the batch size until a batch takes at least minSeconds,
+// then reports the time and heap allocations per call for that batch.
+//
+// Parameters:
+// - double minSeconds: The shortest batch worth reporting.
+// - Function work: The operation to time; it returns how many operations it did.
+//
+// Returns:
+// - BenchmarkResult: Time and allocations per operation.
+template <typename Function>
+BenchmarkResult runBenchmark(double minSeconds, Function work) {
+    BenchmarkResult result;
+    for (long long batch = 1;; batch *= 2) {
+        long long operations = 0;
+        long long before = allocationCount();
+        auto start = chrono::steady_clock::now();
+        for (long long i = 0; i < batch; ++i) {
+            operations += work();
+        }
+        double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        long long allocations = allocationCount() - before;
+
+        if (seconds >= minSeconds || batch >= (1LL << 40)) {
+            result.iterations = operations;
+            result.nsPerOp = seconds * 1e9 / max(1LL, operations);
+            result.allocsPerOp = static_cast<double>(allocations) / max(1LL, operations);
+            return result;
+        }
+    }
+}
+
+// Main function of the benchmark suite
+//
+// Usage: poker_bench [--filter <text>] [--min-time <seconds>]
+// Times the hot paths of a hand: shuffling and dealing, hand evaluation, hand indexing, cached
+// equities, side pots, interaction logging, ranking players and a full headless hand, and
+// prints the time and heap allocations per operation. Only benchmarks whose name contains the
+// filter text are run.
+
+int main(int argc, char* argv[]) {
+    string filter;
+    double minSeconds = 0.5;
+    try {
+        for (int i = 1; i < argc; ++i) {
+            string arg = argv[i];
+            if (arg == "--filter" && i + 1 < argc) {
+                filter = argv[++i];
+            }
+            else if (arg == "--min-time" && i + 1 < argc) {
+                minSeconds = stod(argv[++i]);
+            }
+            else {
+                throw invalid_argument("Unexpected argument: " + arg);
+            }
+        }
+    }
+    catch (const exception& e) {
+        cout << e.what() << endl;
+        return 1;
+    }
+
+    // Fixed inputs shared by the benchmarks, dealt up front so the timed code only does its own work
+    const int NUM_DEALS = 1024;
+    static Card holeCards[NUM_DEALS][MAX_PLAYERS][2];
+    static Card boards[NUM_DEALS][5];
+    Rng rng(42);
+    Deck deck;
+    for (int d = 0; d < NUM_DEALS; ++d) {
+        deck.shuffle(rng, 2 * MAX_PLAYERS + 5);
+        for (int p = 0; p < MAX_PLAYERS; ++p) {
+            holeCards[d][p][0] = deck.dealCard();
+            holeCards[d][p][1] = deck.dealCard();
+        }
+        for (int c = 0; c < 5; ++c) {
+            boards[d][c] = deck.dealCard();
+        }
+    }
+
+    // The same hands in per-card arrays for the batch evaluator, which reports time per hand
+    static uint8_t batchRows[7][NUM_DEALS];
+    static int batchValues[NUM_DEALS];
+    for (int d = 0; d < NUM_DEALS; ++d) {
+        batchRows[0][d] = holeCards[d][0][0].code;
+        batchRows[1][d] = holeCards[d][0][1].code;
+        for (int c = 0; c < 5; ++c) {
+            batchRows[2 + c][d] = boards[d][c].code;
+        }
+    }
+    const uint8_t* const batchCards[7] = { batchRows[0], batchRows[1], batchRows[2], batchRows[3], batchRows[4],
+                                           batchRows[5], batchRows[6] };
+
+    Player players[MAX_PLAYERS];
+    for (int i = 0; i < MAX_PLAYERS; ++i) {
+        players[i] = Player("Bot " + to_string(i + 1));
+    }
+    InterGraph interactions;
+    assignPlayerIds(players, MAX_PLAYERS, interactions);
+    const uint32_t LADDER_PLAYERS = 1000000;
+    Leaderboard ladder;
+    for (uint32_t player = 0; player < LADDER_PLAYERS; ++player) {
+        ladder.update(player, 1000 + rng.below(100000));
+    }
+    HandEvaluator::instance();
+    HandIndexer::holdem(RIVER);
+    EquityCache equityCache;
+    for (int d = 0; d < NUM_DEALS; ++d) {
+        equityCache.equity(holeCards[d][0], boards[d], 5, 1, Player::BOT_EQUITY_TRIALS);
+    }
+    SidePots sidePots;
+    int deal = 0;
+
+    auto dealHands = [&](int d) {
+        for (int p = 0; p < MAX_PLAYERS; ++p) {
+            players[p].hand[0] = holeCards[d][p][0];
+            players[p].hand[1] = holeCards[d][p][1];
+            players[p].folded = false;
+        }
+    };
+
+    struct Benchmark {
+        const char* name;
+        function<long long()> work;
+    };
+    const Benchmark benchmarks[] = {
+        { "Deck::shuffle (52 cards)", [&] {
+            deck.shuffle(rng);
+            benchmarkSink = benchmarkSink + deck.cards[0].code;
+            return 1LL;
+        } },
+        { "Deck::shuffle + dealCard (17 cards)", [&] {
+            deck.shuffle(rng, 17);
+            int sum = 0;
+            for (int i = 0; i < 17; ++i) {
+                sum += deck.dealCard().code;
+            }
+            benchmarkSink = benchmarkSink + sum;
+            return 1LL;
+        } },
+        { "Player::evaluateHandStrength (7 cards)", [&] {
+            deal = (deal + 1) % NUM_DEALS;
+            players[0].hand[0] = holeCards[deal][0][0];
+            players[0].hand[1] = holeCards[deal][0][1];
+            benchmarkSink = benchmarkSink + players[0].evaluateHandStrength(boards[deal], 5);
+            return 1LL;
+        } },
+        { "HandEvaluator::evaluateBatch (per hand)", [&] {
+            HandEvaluator::instance().evaluateBatch(batchCards, NUM_DEALS, batchValues);
+            benchmarkSink = benchmarkSink + batchValues[deal = (deal + 1) % NUM_DEALS];
+            return static_cast<long long>(NUM_DEALS);
+        } },
+        { "HandEvaluator::evaluateBatchScalar", [&] {
+            HandEvaluator::instance().evaluateBatchScalar(batchCards, NUM_DEALS, batchValues);
+            benchmarkSink = benchmarkSink + batchValues[deal = (deal + 1) % NUM_DEALS];
+            return static_cast<long long>(NUM_DEALS);
+        } },
+        { "HandIndexer::index (river)", [&] {
+            deal = (deal + 1) % NUM_DEALS;
+            Card cards[7] = { holeCards[deal][0][0], holeCards[deal][0][1] };
+            copy(boards[deal], boards[deal] + 5, cards + 2);
+            benchmarkSink = benchmarkSink + static_cast<long long>(HandIndexer::holdem(RIVER).index(cards));
+            return 1LL;
+        } },
+        { "HandIndexer::unindex (river)", [&] {
+            deal = (deal + 1) % NUM_DEALS;
+            Card cards[7];
+            HandIndexer::holdem(RIVER).unindex(static_cast<uint64_t>(deal) * 120269, cards);
+            benchmarkSink = benchmarkSink + cards[6].code;
+            return 1LL;
+        } },
+        { "EquityCache::equity (hit, river)", [&] {
+            deal = (deal + 1) % NUM_DEALS;
+            benchmarkSink = benchmarkSink + static_cast<long long>(equityCache.equity(holeCards[deal][0], boards[deal], 5, 1,
+                                                                                      Player::BOT_EQUITY_TRIALS) * 1000);
+            return 1LL;
+        } },
+        { "SidePots::build + award (6 players)", [&] {
+            deal = (deal + 1) % NUM_DEALS;
+            dealHands(deal);
+            sidePots.reset(MAX_PLAYERS);
+            int scores[MAX_PLAYERS];
+            for (int i = 0; i < MAX_PLAYERS; ++i) {
+                sidePots.contribute(i, PREFLOP, 100 * (1 + (holeCards[deal][i][0].code + i) % 4));
+                scores[i] = holeCards[deal][i][1].code % 8; // Few distinct scores, so some pots split
+            }
+            sidePots.build(players);
+            int payouts[MAX_PLAYERS];
+            sidePots.award(scores, deal % MAX_PLAYERS, payouts);
+            benchmarkSink = benchmarkSink + payouts[0];
+            return 1LL;
+        } },
+        { "betInter (6 players)", [&] {
+            betInter(players, MAX_PLAYERS, 50, 1, interactions);
+            return 1LL;
+        } },
+        { "rankPlayers (6 players)", [&] {
+            deal = (deal + 1) % NUM_DEALS;
+            for (int i = 0; i < MAX_PLAYERS; ++i) {
+                players[i].chips = holeCards[deal][i][0].code * 10 + i;
+            }
+            int order[MAX_PLAYERS];
+            rankPlayers(players, MAX_PLAYERS, order);
+            benchmarkSink = benchmarkSink + order[0];
+            return 1LL;
+        } },
+        { "Leaderboard::update (1M players)", [&] {
+            uint32_t player = rng.below(LADDER_PLAYERS);
+            ladder.update(player, ladder.chips(player) + rng.below(2001) - 1000);
+            return 1LL;
+        } },
+        { "Leaderboard::rank (1M players)", [&] {
+            benchmarkSink = benchmarkSink + static_cast<long long>(ladder.rank(rng.below(LADDER_PLAYERS)));
+            return 1LL;
+        } },
+        { "gameLoop (headless hand, 6 bots)", [&] {
+            // Play a short session from fresh stacks; every call reports the hands it played
+            GameOptions options;
+            options.headless = true;
+            options.maxHands = 64;
+            options.seed = static_cast<uint64_t>(++deal);
+            for (int i = 0; i < MAX_PLAYERS; ++i) {
+                players[i].chips = 1000;
+            }
+            return gameLoop(players, MAX_PLAYERS, deck, interactions, options);
+        } },
+    };
+
+    cout << left << setw(42) << "Benchmark" << right << setw(14) << "ns/op" << setw(14) << "allocs/op"
+         << setw(14) << "ops/sec" << setw(14) << "iterations" << "\n";
+    cout << string(98, '-') << "\n";
+    for (const Benchmark& benchmark : benchmarks) {
+        if (!filter.empty() && string(benchmark.name).find(filter) == string::npos) continue;
+
+        // Every benchmark starts from full stacks
+        for (int i = 0; i < MAX_PLAYERS; ++i) {
+            players[i].chips = 1000;
+        }
+        benchmark.work(); // Warm up caches and grow any buffers outside the timed batches
+        BenchmarkResult result = runBenchmark(minSeconds, benchmark.work);
+        cout << left << setw(42) << benchmark.name << right << fixed << setprecision(1) << setw(14) << result.nsPerOp
+             << setprecision(3) << setw(14) << result.allocsPerOp << setprecision(0) << setw(14) << 1e9 / result.nsPerOp
+             << setw(14) << result.iterations << defaultfloat << "\n";
+    }
+    return 0;
+}
@@ -0,0 +1,117 @@
+#ifndef POKER_ACTION_LOG_H
+#define POKER_ACTION_LOG_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace poker {
+
+// Streets of a hand, in the order they are played
+enum Street : uint8_t {
+    PREFLOP,
+    FLOP,
+    TURN,
+    RIVER
+};
+
+// Kinds of betting actions
+enum class ActionType : uint8_t {
+    Bet,
+    Raise,
+    Call,
+    Check,
+    Fold,
+    Bluff,
+    Blind
+};
+
+// Struct for one betting action
+//
+// Eight bytes with no pointers, so a hand's actions sit in one contiguous block that can be
+// scanned, copied or written to disk as is.
+//
+// Members:
+// - uint8_t seat: Index of the acting player in the players array.
+// - Street street: The street the action was taken on.
+// - ActionType type: What the player did.
+// - int32_t amount: For bets, raises and bluffs the street total bet to; for calls and blinds the
+//   chips put in (0 for checks and folds).
+struct ActionRecord {
+    uint8_t seat;
+    Street street;
+    ActionType type;
+    uint8_t reserved;
+    int32_t amount;
+};
+
+static_assert(sizeof(ActionRecord) == 8, "ActionRecord must stay eight bytes");
+
+// Class for the log of betting actions in a hand
+//
+// A fixed-size buffer of ActionRecords. Recording an action is a store into the buffer, with no
+// strings and no allocation; text is only produced by describe() when someone asks for it. A
+// hand longer than CAPACITY actions (a long raising war) spills the rest into a vector, so no
+// action is ever lost; clear() keeps the vector's memory for the next long hand.
+//
+// Methods:
+// - clear(): Empties the log, called at the start of every hand.
+// - setStreet(): Sets the street stamped on the actions that follow.
+// - record(): Appends an action.
+// - size(), operator[]: Read the actions, oldest first.
+// - describe(): Renders one action as a sentence.
+class ActionLog {
+public:
+    static const int CAPACITY = 256;
+
+    ActionLog() : count(0), street(PREFLOP) {}
+
+    void clear() {
+        count = 0;
+        overflow.clear();
+        street = PREFLOP;
+    }
+
+    void setStreet(Street newStreet) {
+        street = newStreet;
+    }
+
+    void record(int seat, ActionType type, int amount = 0) {
+        ActionRecord action = { static_cast<uint8_t>(seat), street, type, 0, amount };
+        if (count < CAPACITY) {
+            records[count] = action;
+        }
+        else {
+            overflow.push_back(action);
+        }
+        count++;
+    }
+
+    int size() const {
+        return count;
+    }
+
+    const ActionRecord& operator[](int index) const {
+        return index < CAPACITY ? records[index] : overflow[index - CAPACITY];
+    }
+
+    // Function to render an action as text
+    //
+    // Parameters:
+    // - const ActionRecord& action: The action to describe.
+    // - const string& playerName: The name of the player at the action's seat.
+    //
+    // Returns:
+    // - string: A sentence such as "Bot 2 calls 50 chips."
+    static std::string describe(const ActionRecord& action, const std::string& playerName);
+
+private:
+    ActionRecord records[CAPACITY];
+    std::vector<ActionRecord> overflow; // Actions after the first CAPACITY
+    int count;                          // Number of actions held
+    Street street;                      // Street stamped on new actions
+};
+
+} // namespace poker
+
+#endif // POKER_ACTION_LOG_H
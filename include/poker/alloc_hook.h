@@ -0,0 +1,20 @@
+#ifndef POKER_ALLOC_HOOK_H
+#define POKER_ALLOC_HOOK_H
+
+namespace poker {
+
+// Allocation counting hook
+//
+// Programs that link src/alloc_hook.cpp replace every form of the global operator new (plain,
+// array, nothrow and over-aligned) so every heap allocation bumps a per-thread counter. Checks
+// read allocationCount() before and after a piece of work to prove it never touches the heap.
+// The engine library itself does not replace operator new; only the tests and the benchmark
+// executable opt in.
+//
+// Returns:
+// - long long: The number of heap allocations made so far by the calling thread.
+long long allocationCount();
+
+} // namespace poker
+
+#endif // POKER_ALLOC_HOOK_H
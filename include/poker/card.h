@@ -0,0 +1,110 @@
+#ifndef POKER_CARD_H
+#define POKER_CARD_H
+
+#include <cstdint>
+#include <string>
+
+namespace poker {
+
+// Constants representing maximum players and cards in the deck
+//
+// MAX_PLAYERS: The maximum number of players that can participate in the game.
+// MAX_CARDS: The total number of cards in a deck.
+
+const int MAX_PLAYERS = 6;
+const int MAX_CARDS = 52;
+
+// Display names of the ranks and suits, indexed by the rank and suit of a Card
+constexpr const char* RANK_NAMES[13] = { "2", "3", "4", "5", "6", "7", "8", "9", "10", "Jack", "Queen", "King", "Ace" };
+constexpr const char* SUIT_NAMES[4] = { "Hearts", "Diamonds", "Clubs", "Spades" };
+
+// Short notation of the ranks and suits, e.g. "Ah" for the Ace of Hearts
+constexpr const char RANK_CHARS[] = "23456789TJQKA";
+constexpr const char SUIT_CHARS[] = "hdcs";
+
+// Compares two display names at compile time
+constexpr bool sameName(const char* a, const char* b) {
+    while (*a != '\0' && *a == *b) {
+        ++a;
+        ++b;
+    }
+    return *a == *b;
+}
+
+// Class representing a playing card
+//
+// Stores the card as a single byte so cards can be copied, compared and dealt in registers.
+// The byte holds rank * 4 + suit, where rank 0 is a Two, rank 12 is an Ace and the suit
+// indexes SUIT_NAMES. An empty card holds NO_CARD.
+//
+// Members:
+// - uint8_t code: The encoded rank and suit of the card.
+//
+// Constructors:
+// - Card(): Initializes the card to the empty card.
+// - Card(int cardCode): Initializes the card from its code (0-51).
+// - Card(const char* cardRank, const char* cardSuit): Initializes the card from display names.
+//
+// Methods:
+// - rankIndex(), suitIndex(): The numeric rank (0-12) and suit (0-3).
+// - rank(), suit(): The display names used when printing cards.
+// - shortName(): The two-character short notation, e.g. "Ah".
+class Card {
+public:
+    static constexpr uint8_t NO_CARD = 0xFF;
+
+    uint8_t code; // rank * 4 + suit, or NO_CARD
+
+    // Default constructor initializing the card to the empty card
+    constexpr Card() : code(NO_CARD) {}
+
+    // Constructor from a card code (0-51)
+    constexpr explicit Card(int cardCode) : code(static_cast<uint8_t>(cardCode)) {}
+
+    // Constructor from display names, e.g. Card("Ace", "Spades"); unknown names give the empty card
+    constexpr Card(const char* cardRank, const char* cardSuit) : code(NO_CARD) {
+        for (int r = 0; r < 13; ++r) {
+            for (int s = 0; s < 4; ++s) {
+                if (sameName(RANK_NAMES[r], cardRank) && sameName(SUIT_NAMES[s], cardSuit)) {
+                    code = static_cast<uint8_t>(r * 4 + s);
+                }
+            }
+        }
+    }
+
+    constexpr bool empty() const { return code == NO_CARD; }
+    constexpr int rankIndex() const { return code >> 2; }
+    constexpr int suitIndex() const { return code & 3; }
+    constexpr const char* rank() const { return empty() ? "" : RANK_NAMES[rankIndex()]; }
+    constexpr const char* suit() const { return empty() ? "" : SUIT_NAMES[suitIndex()]; }
+
+    std::string shortName() const {
+        if (empty()) return "??";
+        return std::string(1, RANK_CHARS[rankIndex()]) + SUIT_CHARS[suitIndex()];
+    }
+
+    constexpr bool operator==(const Card& other) const { return code == other.code; }
+    constexpr bool operator!=(const Card& other) const { return code != other.code; }
+};
+
+static_assert(sizeof(Card) == 1, "Card must stay one byte");
+static_assert(Card("Ace", "Spades").code == 51, "Ace of Spades is the last card code");
+
+// Function to parse cards written in short notation
+//
+// Reads cards such as "AhKd" or "Ts 9s": a rank (2-9, T, J, Q, K, A) followed by a suit (h, d, c, s).
+// "??" stands for an unknown card and is stored as the empty card.
+// Throws invalid_argument if the text is not valid or holds more than maxCards cards.
+//
+// Parameters:
+// - const string& text: The text to parse.
+// - Card cards[]: Array receiving the parsed cards.
+// - int maxCards: The capacity of the cards array.
+//
+// Returns:
+// - int: The number of cards parsed.
+int parseCards(const std::string& text, Card cards[], int maxCards);
+
+} // namespace poker
+
+#endif // POKER_CARD_H
@@ -0,0 +1,168 @@
+#ifndef POKER_CFR_H
+#define POKER_CFR_H
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+#include "poker/action_log.h"
+#include "poker/card.h"
+#include "poker/rng.h"
+
+namespace poker {
+
+// Actions of the abstract game the bots are trained on
+//
+// Call also covers checking, and a raise is always by one bet unit.
+enum class CfrAction : uint8_t {
+    Fold,
+    Call,
+    Raise
+};
+
+const char STRATEGY_MAGIC[4] = { 'P', 'K', 'S', 'T' };
+const char CHECKPOINT_MAGIC[4] = { 'P', 'K', 'C', 'P' };
+const uint32_t STRATEGY_VERSION = 1;
+
+// Class for a trained bot strategy
+//
+// Holds the probability of each abstract action in every information set. An information set
+// is what a bot knows when it acts, reduced to the street, the number of raises so far on the
+// street (the betting abstraction caps it at MAX_RAISES), whether it faces a bet, and its hand
+// strength bucket: the chance of beating one random hand by the river, cut into BUCKETS equal
+// slices. That leaves NUM_INFOSETS information sets, a few kilobytes of table.
+//
+// Strategy files start with a small header (magic, version, abstraction sizes and the number of
+// training iterations) followed by the probabilities as floats.
+//
+// Methods:
+// - Strategy(): Plays every legal action with equal probability.
+// - infoSet(), bucket(): Map a situation to its information set.
+// - probabilities(): The action probabilities of an information set.
+// - choose(): Draws a legal action.
+// - save(), load(): Write and read strategy files, throwing runtime_error on failure.
+class Strategy {
+public:
+    static const int BUCKETS = 16;
+    static const int MAX_RAISES = 2;
+    static const int NUM_ACTIONS = 3;
+    static const int NUM_INFOSETS = 4 * (MAX_RAISES + 1) * 2 * BUCKETS;
+
+    Strategy();
+
+    // Function to find the information set of a situation
+    //
+    // Parameters:
+    // - Street street: The street being bet on.
+    // - int raises: Bets and raises made on the street so far (capped at MAX_RAISES).
+    // - bool facingBet: Whether there is a bet to call.
+    // - int bucket: The hand strength bucket (see bucket()).
+    //
+    // Returns:
+    // - int: The information set, 0 to NUM_INFOSETS - 1.
+    static int infoSet(Street street, int raises, bool facingBet, int bucket) {
+        raises = raises < MAX_RAISES ? raises : MAX_RAISES;
+        return ((static_cast<int>(street) * (MAX_RAISES + 1) + raises) * 2 + (facingBet ? 1 : 0)) * BUCKETS + bucket;
+    }
+
+    // Returns the bucket of a hand strength between 0 and 1
+    static int bucket(double handStrength) {
+        int b = static_cast<int>(handStrength * BUCKETS);
+        return b < 0 ? 0 : b >= BUCKETS ? BUCKETS - 1 : b;
+    }
+
+    const float* probabilities(int infoSet) const {
+        return table[infoSet];
+    }
+
+    void setProbabilities(int infoSet, const float probabilities[NUM_ACTIONS]);
+
+    // Function to draw an action for an information set
+    //
+    // Actions that are not legal here get no probability and the rest are rescaled.
+    //
+    // Parameters:
+    // - int infoSet: The information set.
+    // - bool canFold, bool canRaise: Which of the optional actions are legal.
+    // - Rng& rng: The generator to draw with.
+    //
+    // Returns:
+    // - CfrAction: The action drawn.
+    CfrAction choose(int infoSet, bool canFold, bool canRaise, Rng& rng) const;
+
+    long long iterations() const {
+        return trained;
+    }
+
+    void setIterations(long long iterations) {
+        trained = iterations;
+    }
+
+    void save(const std::string& path) const;
+    void load(const std::string& path);
+
+private:
+    float table[NUM_INFOSETS][NUM_ACTIONS];
+    long long trained; // Training iterations the strategy came from
+};
+
+// Class for the Monte Carlo counterfactual regret minimization trainer
+//
+// Trains Strategy by self-play on an abstracted heads-up game: fixed-limit betting with the
+// table's blinds, bets of one big blind before the turn and two after it, at most MAX_RAISES
+// bets and raises per street, and the hand strength buckets as the only card information.
+// Each iteration deals a hand and runs an external-sampling traversal for each player: the
+// traverser tries every action, the opponent and the cards are sampled.
+//
+// Regrets and strategy sums are shared atomic float tables that every worker updates without
+// locks. Updates can land in any order, which MCCFR tolerates, so the speed-up is close to linear
+// in the number of cores. A checkpoint stores both tables and the iteration count so training
+// can be stopped and resumed.
+//
+// Methods:
+// - CfrTrainer(uint64_t seed): Starts from zero regrets.
+// - train(): Runs iterations on a thread pool.
+// - averageStrategy(): The strategy the bots should play, the average over training.
+// - saveCheckpoint(), loadCheckpoint(): Write and resume training state, throwing runtime_error on failure.
+class CfrTrainer {
+public:
+    static const int HAND_STRENGTH_SAMPLES = 128; // Runouts sampled to bucket a hand
+
+    explicit CfrTrainer(uint64_t seed);
+
+    CfrTrainer(const CfrTrainer&) = delete;
+    CfrTrainer& operator=(const CfrTrainer&) = delete;
+
+    // Function to run training iterations
+    //
+    // Parameters:
+    // - long long iterations: The number of hands to train on.
+    // - int numThreads: Worker threads, 0 for one per core.
+    void train(long long iterations, int numThreads = 0);
+
+    long long iterations() const {
+        return done.load();
+    }
+
+    Strategy averageStrategy() const;
+
+    void saveCheckpoint(const std::string& path) const;
+    void loadCheckpoint(const std::string& path);
+
+private:
+    struct Deal;
+    struct Node;
+
+    std::atomic<float> regrets[Strategy::NUM_INFOSETS][Strategy::NUM_ACTIONS];
+    std::atomic<float> strategySums[Strategy::NUM_INFOSETS][Strategy::NUM_ACTIONS];
+    std::atomic<long long> done;
+    uint64_t seed;
+
+    void iterate(uint64_t iterationSeed);
+    static bool applyAction(Node& node, CfrAction action, const Deal& deal, int traverser, float& utility);
+    float traverse(const Deal& deal, const Node& node, int traverser, Rng& rng);
+};
+
+} // namespace poker
+
+#endif // POKER_CFR_H
@@ -0,0 +1,86 @@
+#ifndef POKER_DECK_H
+#define POKER_DECK_H
+
+#include <algorithm>
+#include <stdexcept>
+
+#include "poker/card.h"
+#include "poker/rng.h"
+
+namespace poker {
+
+// Class representing a deck of cards
+//
+// The deck contains all 52 cards used in the game. It allows shuffling and dealing cards to players.
+//
+// Members:
+// - Card cards[MAX_CARDS]: Array of Card objects representing the deck (52 bytes, one cache line).
+// - int topCardIndex: Index of the top card to be dealt, which keeps track of dealt cards.
+//
+// Methods:
+// - Deck(): Initializes the deck with all 52 cards (13 ranks for each of the 4 suits).
+// - shuffle(): Shuffles the deck to randomize the order of cards.
+// - dealCard(): Deals the top card from the deck to a player.
+class Deck {
+public:
+    alignas(64) Card cards[MAX_CARDS]; // Array of Card objects representing the deck
+    int topCardIndex; // Index of the top card to be dealt
+
+    // Constructor initializing the deck with all cards
+    Deck() : topCardIndex(0) {
+        sortCards();
+    }
+
+    // Function to shuffle the deck with a partial Fisher-Yates shuffle
+    //
+    // Puts the deck back in its original order and randomizes only the first cardsNeeded cards,
+    // which is all a hand will deal. Starting from the same order every time means the cards of a
+    // hand depend only on the generator's state, so a seed replays the same deal.
+    // The deck is ready to deal from the top afterwards.
+    //
+    // Parameters:
+    // - Rng& rng: The table's random number generator.
+    // - int cardsNeeded: How many cards will be dealt from the top.
+    void shuffle(Rng& rng, int cardsNeeded = MAX_CARDS) {
+        sortCards();
+        cardsNeeded = std::min(cardsNeeded, MAX_CARDS - 1);
+        for (int i = 0; i < cardsNeeded; ++i) {
+            int j = i + static_cast<int>(rng.below(static_cast<uint32_t>(MAX_CARDS - i)));
+            std::swap(cards[i], cards[j]);
+        }
+        topCardIndex = 0;
+    }
+
+    // Function to deal the top card from the deck
+    // Returns the card at the top of the deck and increments the top card index.
+    // Throws an exception if no cards are left in the deck.
+    Card dealCard() {
+        if (topCardIndex < MAX_CARDS) {
+            return cards[topCardIndex++];
+        }
+        else {
+            throw std::runtime_error("No cards left in the deck.");
+        }
+    }
+
+    // Function to reset the deck
+    // Resets the deck by setting the top card index back to 0.
+    void reset() {
+        topCardIndex = 0;
+    }
+
+private:
+    // Puts the cards in their original order: each suit in turn, Two to Ace
+    void sortCards() {
+        int index = 0;
+        for (int suit = 0; suit < 4; ++suit) {
+            for (int rank = 0; rank < 13; ++rank) {
+                cards[index++] = Card(rank * 4 + suit);
+            }
+        }
+    }
+};
+
+} // namespace poker
+
+#endif // POKER_DECK_H
@@ -0,0 +1,41 @@
+#ifndef POKER_ENGINE_H
+#define POKER_ENGINE_H
+
+// The whole public API of the poker engine library
+//
+// - card.h, deck.h, rng.h: Cards, the deck and the random number generator.
+// - hand_evaluator.h, equity.h, preflop.h: Hand scoring, win probabilities and the preflop table.
+// - equity_cache.h: The equity cache shared by the bots of every table.
+// - hand_indexer.h: Numbering hands up to suit isomorphism, for tables keyed by situation.
+// - player.h, action_log.h: Players and the actions they take.
+// - cfr.h: The bot strategy and the trainer that produces it.
+// - table.h, side_pots.h: The table state machine that plays a hand one action at a time, and its pots.
+// - game.h, game_state.h: The showdown, the console helpers, the game loop and saved games.
+// - inter_graph.h, rankings.h: Who played whom and how players rank.
+// - interaction_store.h: Who played whom across every session, on disk.
+// - hand_history.h: Recording and reading hands played.
+// - simulation.h: Many bot tables in parallel.
+
+#include "poker/action_log.h"
+#include "poker/card.h"
+#include "poker/cfr.h"
+#include "poker/deck.h"
+#include "poker/equity.h"
+#include "poker/equity_cache.h"
+#include "poker/game.h"
+#include "poker/game_state.h"
+#include "poker/hand_evaluator.h"
+#include "poker/hand_history.h"
+#include "poker/hand_indexer.h"
+#include "poker/inter_graph.h"
+#include "poker/interaction_store.h"
+#include "poker/player.h"
+#include "poker/preflop.h"
+#include "poker/range.h"
+#include "poker/rankings.h"
+#include "poker/rng.h"
+#include "poker/side_pots.h"
+#include "poker/simulation.h"
+#include "poker/table.h"
+
+#endif // POKER_ENGINE_H
@@ -0,0 +1,99 @@
+#ifndef POKER_EQUITY_H
+#define POKER_EQUITY_H
+
+#include <cstdint>
+
+#include "poker/card.h"
+#include "poker/hand_evaluator.h"
+
+namespace poker {
+
+// Struct holding the outcome of an equity calculation
+//
+// Members:
+// - double win[MAX_PLAYERS]: Probability that each player wins the whole pot.
+// - double tie[MAX_PLAYERS]: Probability that each player splits the pot.
+// - double equity[MAX_PLAYERS]: Expected share of the pot for each player.
+// - long long trials: Number of runouts the result is based on.
+struct EquityResult {
+    double win[MAX_PLAYERS] = {};
+    double tie[MAX_PLAYERS] = {};
+    double equity[MAX_PLAYERS] = {};
+    long long trials = 0;
+};
+
+// Class for the Monte Carlo equity engine
+//
+// Deals the unknown cards (the rest of the board and any hole cards left empty) at random
+// and scores every player with the HandEvaluator. The trials are split into fixed-size
+// chunks, each with its own random generator seeded from the caller's seed and the chunk
+// number, and threads pull chunks from a shared counter. Counts are kept as integers so a
+// given seed gives the same result no matter how many threads run.
+//
+// When every hole card is known the exact answer can be computed instead: enumerate()
+// numbers each board completion in combinatorial order, so a chunk of boards is reached
+// by unranking its first index rather than by shuffling a Deck.
+//
+// Either way runouts are dealt into per-card arrays a batch at a time and every player's
+// hands are scored with one HandEvaluator::evaluateBatch() call per batch.
+//
+// Methods:
+// - monteCarlo(): Estimates win, tie and equity for every player.
+// - enumerate(): Computes exact win, tie and equity for every player.
+class EquityCalculator {
+public:
+    static constexpr long long CHUNK_TRIALS = 16384;
+
+    // Function to estimate equity by sampling runouts
+    //
+    // Parameters:
+    // - const Card holeCards[][2]: Hole cards of each player; empty cards are dealt at random.
+    // - int numPlayers: The number of players (2 to MAX_PLAYERS).
+    // - const Card communityCards[]: The community cards dealt so far.
+    // - int communitySize: The number of community cards dealt (0 to 5).
+    // - long long trials: The number of runouts to sample.
+    // - uint64_t seed: Seed for the random generators.
+    // - int numThreads: Threads to use, 0 for every core.
+    //
+    // Returns:
+    // - EquityResult: The estimated probabilities for each player.
+    static EquityResult monteCarlo(const Card holeCards[][2], int numPlayers, const Card communityCards[], int communitySize,
+                                   long long trials, uint64_t seed, int numThreads = 0);
+
+    // Function to compute exact equity over every board completion
+    //
+    // Parameters:
+    // - const Card holeCards[][2]: Hole cards of each player; all must be known.
+    // - int numPlayers: The number of players (2 to MAX_PLAYERS).
+    // - const Card communityCards[]: The community cards dealt so far.
+    // - int communitySize: The number of community cards dealt (0 to 5).
+    // - int numThreads: Threads to use, 0 for every core.
+    //
+    // Returns:
+    // - EquityResult: The exact probabilities for each player; trials is the number of boards.
+    static EquityResult enumerate(const Card holeCards[][2], int numPlayers, const Card communityCards[], int communitySize,
+                                  int numThreads = 0);
+
+    // Returns n choose k for the small values used with a deck, 0 when k > n
+    static long long binomial(int n, int k);
+
+private:
+    static constexpr long long CHUNK_BOARDS = 4096;
+    static const int BATCH_SIZE = 64; // Runouts scored per evaluateBatch() call
+    // Pot shares are counted in 1/60ths so every split between up to six players is exact
+    static const int SHARE_UNITS = 60;
+
+    struct Tally;
+    struct Setup;
+    struct Batch;
+
+    template <typename ChunkFunction>
+    static Tally runChunks(long long numChunks, int numThreads, const ChunkFunction& runChunk);
+    static void tallyShowdown(const int scores[], int numPlayers, Tally& tally);
+    static void enumerateChunk(const Setup& setup, long long first, long long count, Tally& tally);
+    static void sampleChunk(const Setup& setup, long long chunkTrials, uint64_t seed, Tally& tally);
+};
+
+} // namespace poker
+
+#endif // POKER_EQUITY_H
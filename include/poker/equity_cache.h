@@ -0,0 +1,84 @@
+#ifndef POKER_EQUITY_CACHE_H
+#define POKER_EQUITY_CACHE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include "poker/card.h"
+
+namespace poker {
+
+// Class for a cache of bot equities shared by every table
+//
+// Bots ask for the equity of their hole cards against random hands over and over, and across
+// thousands of simulated tables most situations repeat. The cache keys a situation by its suit
+// isomorphism class (see HandIndexer), the street and the number of opponents, and remembers the
+// equity in a fixed array of slots picked by a hash of the key. Each slot is one 64-bit atomic
+// holding the key and the equity as a float, so lookups and stores need no locks and a reader
+// never sees half an entry; a new situation simply overwrites whatever shared its slot.
+//
+// On a miss the equity is computed for the class's canonical hand with a seed taken from the key,
+// so the answer depends only on the situation: whichever table computes it first, and whether it
+// came from the cache at all, the bots decide the same way and seeded runs replay exactly.
+//
+// Methods:
+// - EquityCache(): Allocates the slots, rounded up to a power of two.
+// - equity(): Looks a situation up, computing and storing it on a miss.
+// - hits(), misses(): Lookup counters.
+// - clear(): Empties the slots and the counters.
+// - install(), installed(): Set and get the cache Player::estimateEquity uses.
+class EquityCache {
+public:
+    static const std::size_t DEFAULT_ENTRIES = 1 << 20; // 8MB
+
+    explicit EquityCache(std::size_t entries = DEFAULT_ENTRIES);
+
+    EquityCache(const EquityCache&) = delete;
+    EquityCache& operator=(const EquityCache&) = delete;
+
+    // Function to find the equity of hole cards against random hands
+    //
+    // Parameters:
+    // - const Card hand[2]: The hole cards.
+    // - const Card communityCards[]: The community cards dealt so far.
+    // - int communitySize: The number of community cards (0, 3, 4 or 5).
+    // - int numOpponents: The number of opponents, 1 to MAX_PLAYERS - 1.
+    // - long long trials: Runouts to sample on a miss.
+    //
+    // Returns:
+    // - double: The expected share of the pot.
+    double equity(const Card hand[2], const Card communityCards[], int communitySize, int numOpponents, long long trials);
+
+    uint64_t hits() const {
+        return hitCount.load(std::memory_order_relaxed);
+    }
+
+    uint64_t misses() const {
+        return missCount.load(std::memory_order_relaxed);
+    }
+
+    std::size_t capacity() const {
+        return mask + 1;
+    }
+
+    void clear();
+
+    // Function to set the cache the bots look equities up in, nullptr for none
+    //
+    // The cache must outlive every game using it.
+    static void install(EquityCache* equityCache);
+
+    static EquityCache* installed();
+
+private:
+    std::unique_ptr<std::atomic<uint64_t>[]> slots; // (key + 1) << 32 | equity bits, 0 when empty
+    std::size_t mask;
+    alignas(64) std::atomic<uint64_t> hitCount;
+    alignas(64) std::atomic<uint64_t> missCount;
+};
+
+} // namespace poker
+
+#endif // POKER_EQUITY_CACHE_H
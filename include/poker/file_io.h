@@ -0,0 +1,33 @@
+#ifndef POKER_FILE_IO_H
+#define POKER_FILE_IO_H
+
+#include <cstddef>
+#include <initializer_list>
+#include <string>
+
+namespace poker {
+
+// Struct for a run of bytes to write to a file
+struct FilePart {
+    const void* data;
+    std::size_t size;
+};
+
+// Function to replace a file so that a crash leaves either the old file or the new one
+//
+// Writes the parts to path + ".tmp", flushes it to disk, renames it over path and flushes the
+// directory, so the rename itself survives a crash. Readers never see a partial or empty file.
+//
+// Parameters:
+// - const string& path: The file to write.
+// - initializer_list<FilePart> parts: The bytes to write, in order.
+//
+// Throws runtime_error if the file cannot be written; path is then left as it was.
+void writeFileAtomically(const std::string& path, std::initializer_list<FilePart> parts);
+
+// Function to flush the directory holding a path to disk, so a rename in it survives a crash
+void syncDirectory(const std::string& path);
+
+} // namespace poker
+
+#endif // POKER_FILE_IO_H
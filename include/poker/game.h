@@ -0,0 +1,212 @@
+#ifndef POKER_GAME_H
+#define POKER_GAME_H
+
+#include <cstdint>
+#include <functional>
+
+#include "poker/action_log.h"
+#include "poker/card.h"
+#include "poker/deck.h"
+#include "poker/equity.h"
+#include "poker/game_state.h"
+#include "poker/hand_history.h"
+#include "poker/inter_graph.h"
+#include "poker/player.h"
+#include "poker/rankings.h"
+#include "poker/rng.h"
+#include "poker/table.h"
+
+namespace poker {
+
+// Function to display the current pot
+//
+// Outputs the total number of chips in the pot for the current round.
+//
+// Parameters:
+// - int pot: The current value of the pot.
+void displayPot(int pot);
+
+// Function to display betting history for the hand
+//
+// Outputs every action recorded during the current hand, rendering the text only now.
+//
+// Parameters:
+// - const ActionLog& actionLog: The actions taken during the hand.
+// - const Player players[]: The players, in the seat order the actions were recorded with.
+void displayBettingHistory(const ActionLog& actionLog, const Player players[]);
+
+// Where the console saves and loads the game
+const char* const GAME_STATE_PATH = "poker_game_state.bin";
+
+// Function to save the game state to a file
+//
+// Saves every player and where the session stands to GAME_STATE_PATH (see writeGameState) and
+// reports whether it worked.
+//
+// Parameters:
+// - const Player players[]: Array of players participating in the game.
+// - int numPlayers: The number of players in the game.
+// - const SessionState& session: The session's seed, hands played and button.
+void saveGameState(const Player players[], int numPlayers, const SessionState& session);
+
+// Function to load the game from a file
+//
+// Loads the players and the session from GAME_STATE_PATH (see readGameState) and reports whether it worked.
+//
+// Parameters:
+// - Player players[]: Array to store the players loaded from the file.
+// - int& numPlayers: The number of players loaded from the file.
+// - SessionState& session: Receives the session to carry on from (see GameOptions::resume).
+//
+// Returns:
+// - bool: True if a game was loaded.
+bool loadGameState(Player players[], int& numPlayers, SessionState& session);
+
+// Function to record betting interactions between players
+//
+// Adds an interaction between all active players in the current betting round, keyed by their ids.
+// Parameters:
+// - Player players[]: The array of players, each with an id.
+// - int numPlayers: Total number of players in the game.
+// - int currentBet: The current betting amount in the round.
+// - long long hand: The number of the hand being played.
+// - InterGraph& interactions: The graph to record interactions.
+void betInter(Player players[], int numPlayers, int currentBet, long long hand, InterGraph& interactions);
+
+// Function to record what the players of a finished hand did against each other
+//
+// Every pair dealt in gets the hand counted. The chips each loser lost go to the winners in
+// proportion to what each won, and players who reached a showdown get it counted with its winners.
+// Parameters:
+// - const Table& table: A table whose hand is over, seating players with ids.
+// - long long hand: The number of the hand.
+// - InterGraph& interactions: The graph to record interactions.
+void handInter(const Table& table, long long hand, InterGraph& interactions);
+
+// Function to give each player a distinct id
+//
+// Players keep an id they already have, so ids stay put across games of one session; players
+// without one, or sharing one, get the lowest id left. The interaction graph learns each name.
+//
+// Parameters:
+// - Player players[]: The array of players.
+// - int numPlayers: The number of players, at most MAX_PLAYERS.
+// - InterGraph& interactions: The graph keyed by the ids.
+void assignPlayerIds(Player players[], int numPlayers, InterGraph& interactions);
+
+// Function to count the players still in the hand
+//
+// Parameters:
+// - Player players[]: The array of players.
+// - int numPlayers: Total number of players in the game.
+//
+// Returns:
+// - int: The number of players who have not folded.
+int countActivePlayers(Player players[], int numPlayers);
+
+// Function to compute exact equity for the players still in the hand
+//
+// Enumerates every remaining board for the hole cards of the players who have not folded.
+// Throws invalid_argument if fewer than two players are left.
+//
+// Parameters:
+// - Player players[]: The array of players.
+// - int numPlayers: Total number of players in the game.
+// - Card communityCards[]: Array of community cards dealt on the table.
+// - int communitySize: The number of community cards available.
+//
+// Returns:
+// - EquityResult: Probabilities indexed by seat; folded players get zero.
+EquityResult activePlayersEquity(const Player players[], int numPlayers, const Card communityCards[], int communitySize);
+
+// Function to display the exact equity of the players still in the hand
+//
+// Shows each player's hole cards with their chance to win, tie and their share of the pot
+// (see activePlayersEquity).
+//
+// Parameters:
+// - const Player players[]: The array of players.
+// - int numPlayers: Total number of players in the game.
+// - const Card communityCards[]: Array of community cards dealt on the table.
+// - int communitySize: The number of community cards to count as dealt.
+void displayEquities(const Player players[], int numPlayers, const Card communityCards[], int communitySize);
+
+// Recursive function to display community cards
+//
+// Parameters:
+// - const Card communityCards[]: Array of community cards.
+// - int index: The current index being processed.
+// - int totalCards: Total number of community cards dealt.
+void recursiveComcard(const Card communityCards[], int index, int totalCards);
+
+// Struct holding the options for a run of gameLoop
+//
+// Members:
+// - bool headless: Play with no console output and without calling pause, continuePlaying or onSave.
+//   Every player must be a bot.
+// - long long maxHands: Stop after this many hands, 0 for no limit.
+// - double maxSeconds: Stop after this much wall-clock time, 0 for no limit.
+// - uint64_t seed: Seed for the session, 0 to pick one at random. Hand n is dealt and played from
+//   a generator seeded with (seed, n), so the same seed replays the same session.
+// - humanAction: Called with the table whenever a player who is not a bot is to act.
+// - strategy: A strategy trained by CfrTrainer for the bots to play, instead of their built-in rules.
+// - leaderboard: A leaderboard to keep up to date as chips change hands.
+// - resume: A session loaded by loadGameState; its hands carry on from its seed, hand count and button.
+// - pause: Called to pause for effect, e.g. before cards are revealed; the engine never sleeps itself.
+// - continuePlaying: Called after every hand; returning false ends the game.
+// - onSave: Called after every hand with the state a saved game would need, to offer to save it.
+//
+// The engine never reads input or sleeps: whoever drives it supplies the callbacks, and any left
+// unset are skipped.
+struct GameOptions {
+    bool headless = false;
+    long long maxHands = 0;
+    double maxSeconds = 0;
+    uint64_t seed = 0;
+    HandHistoryWriter* history = nullptr; // Where to record the hands played, if anywhere
+    uint32_t table = 0;                   // Table number stored with recorded hands
+    std::function<Action(const Table&)> humanAction; // Asks a human player for their action
+    const Strategy* strategy = nullptr;              // Trained strategy for the bots, if any
+    Leaderboard* leaderboard = nullptr;              // Given every player's chips after each hand, keyed by Player::id
+    const SessionState* resume = nullptr;            // A saved session to carry on from, in place of seed
+    std::function<void(int seconds)> pause;          // Pauses for effect
+    std::function<bool()> continuePlaying;           // Asked between hands whether to play another
+    std::function<void(const Player players[], int numPlayers, const SessionState& session)> onSave; // Offered the game between hands
+};
+
+// Function to check whether a player is controlled by the computer
+bool isBot(const Player& player);
+
+// Function to display how a finished hand was won
+//
+// Reveals the hands that reached the showdown and announces who took the main pot and each side pot.
+//
+// Parameters:
+// - const Table& table: A table whose hand is over.
+// - const function<void(int)>& pause: Called to pause before the hands are revealed, if set.
+void displayHandResult(const Table& table, const std::function<void(int seconds)>& pause = nullptr);
+
+// Main game loop
+//
+// Handles the entire gameplay process, including shuffling the deck, dealing cards, managing betting rounds, and determining the winner.
+// Each hand is played on a Table, answering its decisions with botAction for bots and options.humanAction
+// for everyone else; the button moves one seat every hand.
+// In headless mode nothing is printed and no callback but humanAction is called, so bot-only tables
+// can be simulated as fast as the engine allows. Once the interaction graph is sized, a headless hand
+// makes no heap allocations (poker_tests checks it).
+//
+// Parameters:
+// - Player players[]: Array of players participating in the game.
+// - int numPlayers: The number of players in the game.
+// - Deck& deck: The deck of cards used in the game.
+// - InterGraph& interactions: The graph recording who played against whom.
+// - const GameOptions& options: Headless mode, the hand or time budget, the hand history to record to
+//   and how to ask human players for their actions.
+//
+// Returns:
+// - long long: The number of hands played.
+long long gameLoop(Player players[], int numPlayers, Deck& deck, InterGraph& interactions, const GameOptions& options = GameOptions());
+
+} // namespace poker
+
+#endif // POKER_GAME_H
@@ -0,0 +1,91 @@
+#ifndef POKER_GAME_STATE_H
+#define POKER_GAME_STATE_H
+
+#include <cstdint>
+#include <string>
+
+#include "poker/player.h"
+
+namespace poker {
+
+const char GAME_STATE_MAGIC[4] = { 'P', 'K', 'G', 'S' };
+const uint32_t GAME_STATE_VERSION = 1;
+
+// Struct for the header at the start of a saved game
+//
+// The header is followed by records, each a GameStateRecordHeader and its payload, and ends with
+// an END record holding the CRC-32 of every byte before it.
+struct GameStateHeader {
+    char magic[4];     // "PKGS"
+    uint32_t version;  // Raised only when old readers must refuse the file; additions need no new version
+};
+
+static_assert(sizeof(GameStateHeader) == 8, "GameStateHeader is part of the file format");
+
+// Struct for the header of one record in a saved game
+struct GameStateRecordHeader {
+    uint16_t tag;      // What the record holds, see GameStateTag
+    uint16_t reserved;
+    uint32_t length;   // Bytes of payload that follow
+};
+
+static_assert(sizeof(GameStateRecordHeader) == 8, "GameStateRecordHeader is part of the file format");
+
+// Record tags of a saved game
+//
+// New kinds of record get new tags and readers skip tags they do not know. A record only ever
+// grows at its end: readers take the fields a record is long enough to hold, leave the rest at
+// their defaults and skip whatever follows the fields they know.
+enum GameStateTag : uint16_t {
+    GAME_STATE_END = 0,     // uint32_t CRC-32 of the file up to this record
+    GAME_STATE_SESSION = 1, // uint64_t seed, uint64_t hands played, int32_t button
+    GAME_STATE_PLAYER = 2,  // int32_t chips, gamesWon, handsPlayed, handsWon, id; uint16_t name length; the name
+};
+
+// Struct for where a session stands between hands
+//
+// Hands are dealt from the session seed and the hand number, so together with the players
+// this is everything needed to carry on: the next hand is dealt exactly as it would have been.
+//
+// Members:
+// - uint64_t seed: The session seed.
+// - long long handsPlayed: The hands played so far.
+// - int button: The seat that had the dealer button in the last hand, -1 before the first.
+struct SessionState {
+    uint64_t seed = 0;
+    long long handsPlayed = 0;
+    int button = -1;
+};
+
+// Function to write a saved game
+//
+// The file is written next to its destination under a temporary name, flushed to disk and then
+// renamed over the destination, so a crash leaves either the old save or the new one, never a
+// mix. Names are stored with their length, so they may hold any characters.
+//
+// Parameters:
+// - const string& path: The file to write.
+// - const Player players[]: The players, in their seats.
+// - int numPlayers: The number of players.
+// - const SessionState& session: Where the session stands.
+//
+// Throws runtime_error if the file cannot be written.
+void writeGameState(const std::string& path, const Player players[], int numPlayers, const SessionState& session);
+
+// Function to read a saved game
+//
+// Parameters:
+// - const string& path: The file to read.
+// - Player players[]: Receives the players, at most MAX_PLAYERS.
+// - int& numPlayers: Receives the number of players.
+// - SessionState& session: Receives where the session stands.
+//
+// Returns:
+// - bool: False if there is no such file.
+//
+// Throws runtime_error if the file is not a saved game, is damaged or needs a newer reader.
+bool readGameState(const std::string& path, Player players[], int& numPlayers, SessionState& session);
+
+} // namespace poker
+
+#endif // POKER_GAME_STATE_H
@@ -0,0 +1,157 @@
+#ifndef POKER_HAND_EVALUATOR_H
+#define POKER_HAND_EVALUATOR_H
+
+#include <cstdint>
+#include <vector>
+
+#include "poker/card.h"
+
+namespace poker {
+
+// Hand categories from weakest to strongest
+//
+// Every evaluated hand falls into exactly one category. The numeric value
+// returned by HandEvaluator orders hands inside and across categories.
+enum HandCategory {
+    HIGH_CARD,
+    ONE_PAIR,
+    TWO_PAIR,
+    THREE_OF_A_KIND,
+    STRAIGHT,
+    FLUSH,
+    FULL_HOUSE,
+    FOUR_OF_A_KIND,
+    STRAIGHT_FLUSH
+};
+
+// Class for the 5 to 7 card hand evaluator
+//
+// Scores any 5, 6 or 7 card hand with a value between 1 (7-5-4-3-2 offsuit)
+// and 7462 (royal flush). Two hands have the same value exactly when they
+// belong to the same equivalence class, so values can be compared directly.
+//
+// All tables are built once on first use:
+// - flushTable: best flush or straight flush for every 13-bit rank mask of one suit.
+// - noFlushTable: best hand for every multiset of ranks, addressed by a perfect
+//   hash over the per-rank counts (each count is 0-4, like a base-5 number).
+//
+// Methods:
+// - instance(): Returns the shared evaluator, building the tables on first call.
+// - evaluate(): Scores an array of cards or a HandState built one card at a time.
+// - evaluateBatch(): Scores many seven-card hands at once, with AVX2 where the CPU has it.
+// - category(): Returns the HandCategory of a value.
+// - categoryName(): Returns a printable name for the category of a value.
+class HandEvaluator {
+public:
+    static const int NUM_CLASSES = 7462;
+
+    // Returns the shared evaluator
+    static const HandEvaluator& instance() {
+        static const HandEvaluator evaluator;
+        return evaluator;
+    }
+
+    // Struct for a hand that cards can be added to one at a time
+    //
+    // Lets callers that score many hands sharing cards (hole cards, a partial board)
+    // build the common part once and copy it.
+    struct HandState {
+        uint8_t counts[13] = {};     // Cards of each rank
+        uint8_t suitCounts[4] = {};  // Cards of each suit
+        uint16_t suitMasks[4] = {};  // Ranks present in each suit
+        int numCards = 0;
+
+        void add(Card card) {
+            int rank = card.rankIndex();
+            int suit = card.suitIndex();
+            counts[rank]++;
+            suitCounts[suit]++;
+            suitMasks[suit] |= static_cast<uint16_t>(1u << rank);
+            numCards++;
+        }
+    };
+
+    // Function to score a hand
+    //
+    // Parameters:
+    // - const Card cards[]: The cards to score, no duplicates.
+    // - int numCards: The number of cards, 5 to 7.
+    //
+    // Returns:
+    // - int: The hand value (1-7462, higher is better), or 0 for fewer than 5 cards.
+    int evaluate(const Card cards[], int numCards) const {
+        if (numCards < 5 || numCards > 7) return 0;
+        HandState state;
+        for (int i = 0; i < numCards; ++i) {
+            state.add(cards[i]);
+        }
+        return evaluate(state);
+    }
+
+    // Function to score a hand built up in a HandState
+    //
+    // Returns:
+    // - int: The hand value (1-7462, higher is better), or 0 for fewer than 5 cards.
+    int evaluate(const HandState& state) const {
+        if (state.numCards < 5 || state.numCards > 7) return 0;
+
+        // With at most 7 cards a flush rules out quads and full houses,
+        // so the flush table alone decides the hand.
+        for (int suit = 0; suit < 4; ++suit) {
+            if (state.suitCounts[suit] >= 5) return flushTable[state.suitMasks[suit]];
+        }
+
+        uint32_t hash = 0;
+        int remaining = state.numCards;
+        for (int rank = 0; rank < 13; ++rank) {
+            hash += hashTerms[rank][remaining][state.counts[rank]];
+            remaining -= state.counts[rank];
+        }
+        return noFlushTables[state.numCards][hash];
+    }
+
+    // Function to score many seven-card hands in one call
+    //
+    // The hands come in structure-of-arrays layout: cards[i][h] is the i-th card of hand h, so
+    // each of the seven arrays is read front to back. On x86-64 CPUs with AVX2, eight hands are
+    // scored at a time with vector gathers from the same tables; elsewhere, and for the last few
+    // hands, one at a time. Either way the values are exactly those of evaluate().
+    //
+    // Parameters:
+    // - const uint8_t* const cards[7]: Seven arrays of card codes, one per card position.
+    // - int numHands: The number of hands.
+    // - int values[]: Receives the value of each hand.
+    void evaluateBatch(const uint8_t* const cards[7], int numHands, int values[]) const;
+
+    // Same as evaluateBatch(), one hand at a time on any CPU
+    void evaluateBatchScalar(const uint8_t* const cards[7], int numHands, int values[]) const;
+
+    // Returns whether evaluateBatch() runs the AVX2 code on this CPU
+    static bool usesAvx2();
+
+    // Returns the category a hand value belongs to
+    static HandCategory category(int value) {
+        // Upper bound of each category in the 1-7462 ordering
+        static const int bounds[] = { 1277, 4137, 4995, 5853, 5863, 7140, 7296, 7452, 7462 };
+        for (int c = 0; c < 9; ++c) {
+            if (value <= bounds[c]) return static_cast<HandCategory>(c);
+        }
+        return STRAIGHT_FLUSH;
+    }
+
+    // Returns the printable name of the category a hand value belongs to
+    static const char* categoryName(int value);
+
+private:
+    uint16_t flushTable[8192 + 2];           // Padded so 32-bit gathers of the last entry stay inside
+    std::vector<uint16_t> noFlushTables[8];  // Indexed by card count (5-7)
+    uint32_t hashTerms[13][8][5];            // Perfect hash contribution of rank, cards left, count
+
+    HandEvaluator();
+
+    void evaluateBatchAvx2(const uint8_t* const cards[7], int numHands, int values[]) const;
+};
+
+} // namespace poker
+
+#endif // POKER_HAND_EVALUATOR_H
@@ -0,0 +1,170 @@
+#ifndef POKER_HAND_HISTORY_H
+#define POKER_HAND_HISTORY_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "poker/action_log.h"
+#include "poker/card.h"
+
+namespace poker {
+
+// Struct for the header at the start of a hand history file
+struct HandHistoryHeader {
+    char magic[4];     // "PKHH"
+    uint32_t version;
+    uint32_t recordAlignment;
+    uint32_t reserved;
+};
+
+static_assert(sizeof(HandHistoryHeader) == 16, "HandHistoryHeader must stay sixteen bytes");
+
+// Struct for one hand in a hand history file
+//
+// Every hand is stored as this fixed-size block followed by numActions ActionRecords. Records
+// are plain data with a fixed layout, so a reader can use them straight out of a mapped file.
+//
+// Members:
+// - uint32_t size: Bytes in the record, actions included; used to step to the next hand.
+// - uint32_t table: The table the hand was played at, for batch simulations.
+// - uint64_t handNumber: The hand's number within its session, starting at 1.
+// - uint64_t seed: The seed the hand was dealt from.
+// - int32_t pot: Chips in the pot at showdown.
+// - uint16_t numActions: The number of ActionRecords that follow.
+// - uint8_t numSeats: The number of players dealt in.
+// - uint8_t boardSize: The number of community cards dealt.
+// - int8_t winner: The winning seat, or -1 if nobody won.
+// - char names[][16]: Each seat's player name, cut to 15 characters.
+// - Card board[5], holeCards[][2]: The cards, empty where none were dealt.
+struct HandRecord {
+    uint32_t size;
+    uint32_t table;
+    uint64_t handNumber;
+    uint64_t seed;
+    int32_t pot;
+    uint16_t numActions;
+    uint8_t numSeats;
+    uint8_t boardSize;
+    int8_t winner;
+    uint8_t reserved[3];
+    char names[MAX_PLAYERS][16];
+    Card board[5];
+    Card holeCards[MAX_PLAYERS][2];
+    uint8_t padding[3];
+};
+
+static_assert(sizeof(HandRecord) == 152 && sizeof(HandRecord) % alignof(ActionRecord) == 0,
+              "HandRecord layout is part of the file format");
+
+const char HAND_HISTORY_MAGIC[4] = { 'P', 'K', 'H', 'H' };
+const uint32_t HAND_HISTORY_VERSION = 1;
+
+// Class for appending hands to a hand history file
+//
+// Hands are appended through a large stdio buffer, so writing one is a memcpy in the common
+// case and the file is written in big sequential chunks. One writer can be shared by the
+// tables of a batch simulation; each hand is written under a lock so records never interleave.
+// A new file gets a header; an existing one is checked, a hand cut short at its end by an
+// interrupted writer is cut off, and new hands are appended after the last complete one.
+//
+// Methods:
+// - HandHistoryWriter(path): Opens the file, throws runtime_error if it cannot or if it is not a hand history.
+// - writeHand(): Appends a hand and its actions, throws runtime_error if it cannot.
+// - close(): Flushes and closes the file, throws runtime_error if the last hands could not be written.
+// - handsWritten(): The number of hands written by this writer.
+class HandHistoryWriter {
+public:
+    explicit HandHistoryWriter(const std::string& path);
+    ~HandHistoryWriter();
+
+    HandHistoryWriter(const HandHistoryWriter&) = delete;
+    HandHistoryWriter& operator=(const HandHistoryWriter&) = delete;
+
+    // Function to append a hand
+    //
+    // Throws runtime_error if the hand has more actions than numActions can count.
+    //
+    // Parameters:
+    // - HandRecord hand: The hand; size and numActions are filled in here.
+    // - const ActionLog& actionLog: The actions taken during the hand.
+    void writeHand(HandRecord hand, const ActionLog& actionLog);
+
+    // Function to flush the buffered hands and close the file
+    //
+    // Call it before the writer is destroyed: the destructor closes the file too, but can only
+    // report a failure on stderr.
+    void close();
+
+    long long handsWritten() const {
+        return hands.load();
+    }
+
+private:
+    std::string path;
+    std::FILE* file;
+    std::vector<char> buffer; // stdio buffer, kept alive for as long as the file is open
+    std::mutex lock;
+    std::atomic<long long> hands;
+};
+
+// Class for reading a hand history file
+//
+// The file is memory-mapped where the platform allows it, and read into memory otherwise.
+// Hands are handed out as pointers into it, so iterating a file parses and copies nothing.
+// A hand cut short at the end of the file, as left by an interrupted writer, ends the
+// iteration; any other damage throws runtime_error.
+//
+// Methods:
+// - HandHistoryReader(path): Opens and checks the file.
+// - next(): Steps to the next hand.
+// - rewind(): Goes back to the first hand.
+class HandHistoryReader {
+public:
+    // Struct for a view of one hand inside the file
+    struct Hand {
+        const HandRecord* record;
+        const ActionRecord* actions;
+    };
+
+    explicit HandHistoryReader(const std::string& path);
+    ~HandHistoryReader();
+
+    HandHistoryReader(const HandHistoryReader&) = delete;
+    HandHistoryReader& operator=(const HandHistoryReader&) = delete;
+
+    // Function to step to the next hand
+    //
+    // Parameters:
+    // - Hand& hand: Set to the next hand; it points into the file and lives as long as the reader.
+    //
+    // Returns:
+    // - bool: False once every complete hand has been read.
+    bool next(Hand& hand);
+
+    void rewind() {
+        offset = sizeof(HandHistoryHeader);
+    }
+
+    // Byte offset just past the last hand read
+    std::size_t position() const {
+        return offset;
+    }
+
+private:
+    void release();
+
+    const char* data;
+    std::size_t length;
+    std::size_t offset;
+    bool mapped;
+    std::vector<char> contents; // Holds the file when it could not be mapped
+};
+
+} // namespace poker
+
+#endif // POKER_HAND_HISTORY_H
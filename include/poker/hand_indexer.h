@@ -0,0 +1,125 @@
+#ifndef POKER_HAND_INDEXER_H
+#define POKER_HAND_INDEXER_H
+
+#include <cstdint>
+#include <vector>
+
+#include "poker/action_log.h"
+#include "poker/card.h"
+
+namespace poker {
+
+// Class for numbering hands up to suit isomorphism
+//
+// Two hands that differ only by renaming suits (AhKh on Qh7d2c and AsKs on Qs7h2d) play the
+// same, so tables keyed by situation only need one entry for each. The indexer maps the cards
+// dealt so far, round by round, to a dense index of their isomorphism class, and unindex() turns
+// an index back into a canonical hand of that class. The order of the cards inside a round does
+// not matter; which round a card was dealt in does.
+//
+// The cards of each suit are numbered on their own: a combination of ranks per round, each taken
+// from the ranks that suit has not used yet. The suits are then sorted by how many cards they got
+// in each round, their configuration, and suits with the same configuration are interchangeable,
+// so their numbers are combined as a multiset. The index is the offset of the hand's suit
+// configuration plus that combined number. Everything is a few table lookups and small loops
+// over the cards, with no allocation; the tables are built by the constructor.
+//
+// For Texas Hold'em equities the order of the board cards does not matter either, so holdem()
+// has one indexer per street with two rounds, the hole cards and the board. Preflop, on the flop,
+// the turn and the river they have 169, 1,286,792, 13,960,050 and 123,156,254 classes: 8, 20,
+// 22 and 23 times fewer than the hands themselves.
+//
+// Methods:
+// - HandIndexer(): Builds the tables for the given cards per round.
+// - holdem(): The shared indexer for a street of Texas Hold'em.
+// - size(): The number of classes, after the last round or any earlier one.
+// - index(): The index of a hand.
+// - unindex(): A canonical hand for an index.
+class HandIndexer {
+public:
+    static const int MAX_ROUNDS = 4;
+    static const int MAX_CARDS_PER_ROUND = 7;
+
+    // Constructor from the number of cards dealt in each round
+    //
+    // Throws invalid_argument for no rounds, more than MAX_ROUNDS, or a round of no cards or more
+    // than MAX_CARDS_PER_ROUND.
+    HandIndexer(const int cardsPerRound[], int numRounds);
+
+    // Returns the shared indexer for the hole cards and the board of a Texas Hold'em street
+    static const HandIndexer& holdem(Street street);
+
+    int rounds() const {
+        return numRounds;
+    }
+
+    // Returns the number of cards dealt up to and including a round
+    int cardsThrough(int round) const {
+        return roundStart[round + 1];
+    }
+
+    uint64_t size(int round) const {
+        return sizes[round];
+    }
+
+    uint64_t size() const {
+        return sizes[numRounds - 1];
+    }
+
+    // Function to find the index of a hand
+    //
+    // Parameters:
+    // - const Card cards[]: The cards dealt up to the round, round by round (for Hold'em the
+    //   hole cards first, then the board).
+    // - int round: The last round dealt, 0 for the first.
+    //
+    // Returns:
+    // - uint64_t: The index of the hand's class, 0 to size(round) - 1.
+    uint64_t index(const Card cards[], int round) const;
+
+    uint64_t index(const Card cards[]) const {
+        return index(cards, numRounds - 1);
+    }
+
+    // Function to build a canonical hand for an index
+    //
+    // Hands with the same index get the same canonical hand, and indexing it gives the index back.
+    //
+    // Parameters:
+    // - int round: The last round dealt.
+    // - uint64_t index: The index, 0 to size(round) - 1.
+    // - Card cards[]: Filled with cardsThrough(round) cards, round by round.
+    void unindex(int round, uint64_t index, Card cards[]) const;
+
+    void unindex(uint64_t index, Card cards[]) const {
+        unindex(numRounds - 1, index, cards);
+    }
+
+private:
+    // Struct for one way the cards can fall into suits, up to renaming suits
+    //
+    // Members:
+    // - uint64_t key: The suits' configurations packed together, largest first (see index()).
+    // - uint64_t offset: The index of the first hand with this configuration.
+    // - uint16_t suits[4]: The cards each suit gets per round, 3 bits a round, largest first.
+    // - uint64_t suitSizes[4]: The number of ways to deal each suit its cards.
+    struct Configuration {
+        uint64_t key;
+        uint64_t offset;
+        uint16_t suits[4];
+        uint64_t suitSizes[4];
+    };
+
+    int numRounds;
+    int cardsPerRound[MAX_ROUNDS];
+    int roundStart[MAX_ROUNDS + 1];
+    uint64_t sizes[MAX_ROUNDS];
+    std::vector<Configuration> configurations[MAX_ROUNDS]; // Sorted by key and by offset
+
+    void addConfigurations(int round);
+    uint64_t suitSize(uint16_t suit, int round) const;
+};
+
+} // namespace poker
+
+#endif // POKER_HAND_INDEXER_H
@@ -0,0 +1,112 @@
+#ifndef POKER_INTER_GRAPH_H
+#define POKER_INTER_GRAPH_H
+
+#include <string>
+
+#include "poker/card.h"
+
+namespace poker {
+
+// Struct for what two players have done against each other
+//
+// Members:
+// - int hands: The hands both players were dealt into.
+// - int count: The betting rounds both players stayed in until the end.
+// - long long chips: The chips bet in those rounds, summed.
+// - long long net: The chips the first player won from the second, negative if they lost them.
+// - int showdowns: The showdowns both players reached.
+// - int showdownWins: The showdowns the first player won or split.
+// - long long lastHand: The most recent hand both were dealt into, 0 if there was none.
+struct Interaction {
+    int hands = 0;
+    int count = 0;
+    long long chips = 0;
+    long long net = 0;
+    int showdowns = 0;
+    int showdownWins = 0;
+    long long lastHand = 0;
+};
+
+// Class for the Interactions Graph
+//
+// Tracks interactions between players, keyed by the player ids gameLoop hands out (0 to
+// MAX_PLAYERS - 1, see Player::id). Each pair of players has one Interaction in a fixed
+// MAX_PLAYERS x MAX_PLAYERS matrix, kept in both orders, so recording an interaction is two
+// updates in place and the graph takes the same memory however long the session runs.
+//
+// Methods:
+// - setName(), name(): The name shown for a player id.
+// - addHand(), addInter(), addFlow(), addShowdown(): Record what two players did in a hand.
+// - between(): The aggregate for a pair of players.
+// - display(): Prints every pair that has interacted.
+// - reset(): Clears every interaction and name.
+class InterGraph {
+public:
+    void setName(int player, const std::string& playerName) {
+        names[player] = playerName;
+    }
+
+    const std::string& name(int player) const {
+        return names[player];
+    }
+
+    // Records that two players were dealt into a hand together
+    void addHand(int player1, int player2, long long hand) {
+        edges[player1][player2].hands++;
+        edges[player2][player1].hands++;
+        edges[player1][player2].lastHand = hand;
+        edges[player2][player1].lastHand = hand;
+    }
+
+    // Add an interaction between two players
+    //
+    // Parameters:
+    // - int player1: The first player's id.
+    // - int player2: The second player's id.
+    // - int chips: The number of chips exchanged in the interaction.
+    // - long long hand: The hand it happened in.
+    void addInter(int player1, int player2, int chips, long long hand) {
+        record(edges[player1][player2], chips, hand);
+        record(edges[player2][player1], chips, hand);
+    }
+
+    // Records chips that went from one player to another
+    void addFlow(int winner, int loser, int chips) {
+        edges[winner][loser].net += chips;
+        edges[loser][winner].net -= chips;
+    }
+
+    // Records a showdown between two players and which of them won (both for a split)
+    void addShowdown(int player1, int player2, bool player1Won, bool player2Won) {
+        edges[player1][player2].showdowns++;
+        edges[player2][player1].showdowns++;
+        edges[player1][player2].showdownWins += player1Won;
+        edges[player2][player1].showdownWins += player2Won;
+    }
+
+    const Interaction& between(int player1, int player2) const {
+        return edges[player1][player2];
+    }
+
+    // Display all interactions in the graph
+    //
+    // Prints each pair of players once, with their totals.
+    void display() const;
+
+    // Reset the graph (clear all interactions)
+    void reset();
+
+private:
+    static void record(Interaction& edge, int chips, long long hand) {
+        edge.count++;
+        edge.chips += chips;
+        edge.lastHand = hand;
+    }
+
+    std::string names[MAX_PLAYERS]; // Player id -> name
+    Interaction edges[MAX_PLAYERS][MAX_PLAYERS]; // Both orders of each pair; the diagonal stays empty
+};
+
+} // namespace poker
+
+#endif // POKER_INTER_GRAPH_H
@@ -0,0 +1,157 @@
+#ifndef POKER_INTERACTION_STORE_H
+#define POKER_INTERACTION_STORE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "poker/inter_graph.h"
+
+namespace poker {
+
+const char INTERACTION_SEGMENT_MAGIC[4] = { 'P', 'K', 'I', 'S' };
+const uint32_t INTERACTION_SEGMENT_VERSION = 1;
+
+// Struct for the header of an interaction segment file
+//
+// The header is followed by one column per field of a row, in this order: uint32_t player[],
+// uint32_t rival[], then uint64_t hands[], rounds[], showdowns[], showdownWins[] and int64_t
+// chips[], net[], each numRows long. Rows are sorted by player and then rival, and every pair of
+// players has a row in both orders, so all of a player's rows sit together.
+struct InteractionSegmentHeader {
+    char magic[4];       // "PKIS"
+    uint32_t version;
+    uint64_t numRows;
+    uint64_t firstHand;  // Store-wide numbers of the first and last hand the segment covers
+    uint64_t lastHand;
+    uint64_t sessions;   // Sessions merged into the segment
+    uint64_t reserved[3];
+};
+
+static_assert(sizeof(InteractionSegmentHeader) == 64, "InteractionSegmentHeader is part of the file format");
+
+// Struct for the totals of one player against another
+//
+// Members:
+// - uint64_t hands, rounds: The hands both were dealt into and the betting rounds both stayed in.
+// - int64_t chips: The chips bet in those rounds.
+// - int64_t net: The chips the player won from the rival, negative if they lost them.
+// - uint64_t showdowns, showdownWins: The showdowns between them and those the player won or split.
+struct InteractionTotals {
+    uint64_t hands = 0;
+    uint64_t rounds = 0;
+    int64_t chips = 0;
+    int64_t net = 0;
+    uint64_t showdowns = 0;
+    uint64_t showdownWins = 0;
+};
+
+// Class for the interactions of every session, kept on disk
+//
+// A store is a directory. Player names are numbered in a dictionary file ("names": "PKIN", then
+// each name as a uint32_t length and its bytes, numbered in order), and every session appended
+// becomes a segment file of the totals per pair of players, stored column by column and sorted
+// so a player's rows can be found by binary search. Both are replaced with writeFileAtomically,
+// the dictionary first, so a reader never sees half a file or a segment using a number with no
+// name. Segments are memory-mapped where the platform allows it: a query touches only the pages
+// of the rows it reads, however much history the store holds.
+//
+// Hands are numbered across the store in the order sessions are appended, and each segment
+// records the hands it covers. Queries can be limited to the last n hands; segments are counted
+// whole, so the window is widened to the segment boundaries. Once there are more than
+// MAX_SEGMENTS segments, appending merges the two neighbouring segments that cover the fewest
+// hands together, so recent history stays finely divided and older history is merged into ever
+// larger segments. Merging adds rows up per pair, so a segment never has more rows than there
+// are pairs of players. compact() merges everything into one segment.
+//
+// Methods:
+// - InteractionStore(directory): Opens a store, creating the directory; throws runtime_error if a file is damaged.
+// - append(): Adds a session's interactions.
+// - between(): The totals of one player against another.
+// - topRivals(): The players someone played the most hands with.
+// - compact(): Merges every segment into one.
+// - hands(), segments(), players(): The size of the store.
+class InteractionStore {
+public:
+    static const int MAX_SEGMENTS = 16;
+
+    // Struct for a rival found by topRivals()
+    struct Rival {
+        std::string name;
+        InteractionTotals totals;
+    };
+
+    explicit InteractionStore(const std::string& directory);
+    ~InteractionStore();
+
+    InteractionStore(const InteractionStore&) = delete;
+    InteractionStore& operator=(const InteractionStore&) = delete;
+
+    // Function to add a session's interactions as a new segment
+    //
+    // Safe to call from several threads at once, e.g. by the tables of a batch simulation.
+    //
+    // Parameters:
+    // - const InterGraph& graph: The session's interactions; players are matched across sessions by name.
+    // - long long sessionHands: The number of hands the session played.
+    void append(const InterGraph& graph, long long sessionHands);
+
+    // Function to find the totals of one player against another
+    //
+    // Parameters:
+    // - const string& player, const string& rival: The players' names.
+    // - long long lastHands: Only count the segments holding the last this many hands, 0 for all.
+    //
+    // Returns:
+    // - InteractionTotals: The player's totals against the rival, all 0 if they never met.
+    InteractionTotals between(const std::string& player, const std::string& rival, long long lastHands = 0) const;
+
+    // Function to find the players someone played the most hands with
+    //
+    // Parameters:
+    // - const string& player: The player's name.
+    // - int count: The most rivals to return.
+    // - long long lastHands: Only count the segments holding the last this many hands, 0 for all.
+    //
+    // Returns:
+    // - vector<Rival>: The rivals with the player's totals against each, most hands first.
+    std::vector<Rival> topRivals(const std::string& player, int count, long long lastHands = 0) const;
+
+    void compact();
+
+    // Number of hands appended to the store
+    long long hands() const;
+
+    int segments() const;
+
+    int players() const;
+
+private:
+    struct Segment;
+
+    uint32_t nameId(const std::string& name);
+    void saveNames();
+    bool findName(const std::string& name, uint32_t& id) const;
+    void openSegments();
+    std::unique_ptr<Segment> writeSegment(const InteractionSegmentHeader& header,
+                                          const std::vector<std::pair<uint64_t, InteractionTotals>>& rows);
+    void merge(std::size_t first, std::size_t last);
+    std::size_t firstInWindow(long long lastHands) const;
+
+    std::string directory;
+    std::vector<std::string> names;                    // Player number -> name
+    std::unordered_map<std::string, uint32_t> nameIds; // Name -> player number
+    std::size_t namesSaved;                             // Names already in the dictionary file
+    std::vector<std::unique_ptr<Segment>> segmentFiles; // Oldest hands first
+    uint64_t nextFile;                                  // Number of the next segment file
+    mutable std::mutex lock;
+};
+
+} // namespace poker
+
+#endif // POKER_INTERACTION_STORE_H
@@ -0,0 +1,123 @@
+#ifndef POKER_PLAYER_H
+#define POKER_PLAYER_H
+
+#include <cstdint>
+#include <string>
+
+#include "poker/card.h"
+#include "poker/range.h"
+
+namespace poker {
+
+// Class representing a player in the game
+//
+// Stores information about each player, including their name, hand, chip count, and game statistics.
+//
+// Members:
+// - string name: The name of the player.
+// - Card hand[2]: Array storing the player's hand (2 cards).
+// - int chips: The number of chips the player currently has.
+// - bool folded: Indicates if the player has folded in the current round.
+// - int gamesWon: The number of games won by the player.
+// - int handsPlayed: The total number of hands played by the player.
+// - int handsWon: The total number of hands won by the player.
+// - int id: The player's key in the interaction graph, given by gameLoop; -1 until then.
+//
+// Methods:
+// - Player(): Default constructor initializing player values.
+// - Player(string playerName): Initializes player with a specific name.
+// - receiveCard(): Adds a card to the player's hand.
+// - showHand(): Displays the cards in the player's hand.
+// - evaluateHandStrength(): Calculates hand strength based on community cards.
+// - estimateEquity(): Estimates the chance of winning against the remaining opponents or a range.
+// - displayPlayerStatistics(): Displays the player's game statistics.
+
+class Player {
+public:
+    static const int BOT_EQUITY_TRIALS = 1000; // Runouts a bot samples per decision (see botAction)
+
+    std::string name; // Player's name
+    Card hand[2]; // Array to store the player's hand (2 cards)
+    int chips; // Number of chips the player has
+    bool folded; // Whether the player has folded
+    int gamesWon; // Number of games won by the player
+    int handsPlayed; // Number of hands played by the player
+    int handsWon; // Number of hands won by the player
+    int id; // Stable id (0 to MAX_PLAYERS - 1) that lasts across sessions, -1 if not given yet
+
+    // Default constructor initializing player with default values
+    Player() : name(""), chips(1000), folded(false), gamesWon(0), handsPlayed(0), handsWon(0), id(-1) {}
+
+    // Parameterized constructor initializing player with a specific name
+    Player(std::string playerName) : name(playerName), chips(1000), folded(false), gamesWon(0), handsPlayed(0), handsWon(0), id(-1) {}
+
+    // Function to receive a card
+    //
+    // Adds a card to the player's hand at the specified index.
+    //
+    // Parameters:
+    // - Card card: The card to be added to the player's hand.
+    // - int index: The index (0 or 1) to place the card in the player's hand.
+    void receiveCard(Card card, int index) {
+        if (index < 2) {
+            hand[index] = card;
+        }
+    }
+
+    // Function to display the player's hand
+    //
+    // Outputs the player's hand to the console, showing both cards.
+    void showHand(bool hideCards = false);
+
+    // Function to evaluate hand strength based on community cards
+    //
+    // Scores the best five-card hand made from the player's hand and the community cards
+    // using the lookup-table HandEvaluator.
+    //
+    // Parameters:
+    // - const Card communityCards[]: Array of community cards dealt on the table.
+    // - int communitySize: The number of community cards available.
+    //
+    // Returns:
+    // - int: The hand value (1-7462, higher is better), or 0 before the flop.
+    int evaluateHandStrength(const Card communityCards[], int communitySize);
+
+    // Function to estimate the chance of winning against unknown opponents
+    //
+    // Runs a small single-threaded Monte Carlo simulation with the opponents' hole cards unknown.
+    // Before the flop it looks the equity up in the installed PreflopTable instead, if there is one,
+    // and otherwise asks the installed EquityCache, which ignores the seed.
+    //
+    // Parameters:
+    // - const Card communityCards[]: Array of community cards dealt on the table.
+    // - int communitySize: The number of community cards available.
+    // - int numOpponents: The number of other players still in the hand.
+    // - uint64_t seed: Seed for the simulation when there is no cache.
+    //
+    // Returns:
+    // - double: The expected share of the pot (0 to 1).
+    double estimateEquity(const Card communityCards[], int communitySize, int numOpponents, uint64_t seed);
+
+    // Function to compute the chance of winning against one opponent holding a hand from a range
+    //
+    // Weighs every hand in the range that the player's cards and the board leave possible (see
+    // rangeEquity); exact on the river, sampled over board completions before it.
+    //
+    // Parameters:
+    // - const Card communityCards[]: Array of community cards dealt on the table.
+    // - int communitySize: The number of community cards available.
+    // - const Range& opponentRange: The hands the opponent might hold.
+    //
+    // Returns:
+    // - double: The expected share of the pot (0 to 1), 0 if no hand in the range is possible.
+    double estimateEquity(const Card communityCards[], int communitySize, const Range& opponentRange);
+
+    // Function to display player statistics
+    //
+    // Outputs detailed information about the player's performance, including chips, games won, hands played, and hands won.
+    void displayPlayerStatistics();
+};
+
+} // namespace poker
+
+#endif // POKER_PLAYER_H
@@ -0,0 +1,110 @@
+#ifndef POKER_PREFLOP_H
+#define POKER_PREFLOP_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "poker/card.h"
+
+namespace poker {
+
+const char PREFLOP_MAGIC[4] = { 'P', 'K', 'P', 'F' };
+const uint32_t PREFLOP_VERSION = 1;
+
+// Struct for the header of a preflop equity file
+struct PreflopHeader {
+    char magic[4];       // "PKPF"
+    uint32_t version;
+    uint32_t numClasses;
+    uint32_t maxOpponents;
+    uint64_t trials;     // Runouts sampled per entry
+    uint64_t reserved;
+};
+
+static_assert(sizeof(PreflopHeader) == 32, "PreflopHeader is part of the file format");
+
+// Class for the table of preflop equities of the 169 starting hands
+//
+// Before the flop only the ranks of the hole cards and whether they are suited matter, so the
+// 1326 possible starting hands fall into 169 classes: 13 pairs, 78 suited and 78 offsuit hands.
+// Classes are laid out on the usual 13x13 grid, row * 13 + column: pairs on the diagonal,
+// suited hands with the higher rank as the row and offsuit hands with the higher rank as the column.
+//
+// build() computes the equity of every class against 1 to MAX_OPPONENTS random hands with the
+// equity engine and writes a header followed by a float[NUM_CLASSES][MAX_OPPONENTS] table, under
+// 4KB. Opening the file maps it into memory, so a lookup is one load. install() makes a table the
+// one Player::estimateEquity uses before the flop, in place of its Monte Carlo simulation.
+//
+// Methods:
+// - PreflopTable(path): Opens a table file, throws runtime_error if it is missing or damaged.
+// - equity(): The equity of a class or a pair of hole cards.
+// - handClass(), className(): Map hole cards to their class and a class to its name ("AKs").
+// - build(): Computes a table and writes it to a file.
+// - install(), installed(): Set and get the table used by the bots.
+class PreflopTable {
+public:
+    static const int NUM_CLASSES = 169;
+    static const int MAX_OPPONENTS = MAX_PLAYERS - 1;
+    static const long long DEFAULT_TRIALS = 200000;
+
+    explicit PreflopTable(const std::string& path);
+    ~PreflopTable();
+
+    PreflopTable(const PreflopTable&) = delete;
+    PreflopTable& operator=(const PreflopTable&) = delete;
+
+    // Returns the expected share of the pot of a class against 1 to MAX_OPPONENTS random hands
+    float equity(int handClass, int numOpponents) const {
+        return table[handClass * MAX_OPPONENTS + numOpponents - 1];
+    }
+
+    float equity(Card first, Card second, int numOpponents) const {
+        return equity(handClass(first, second), numOpponents);
+    }
+
+    long long trials() const {
+        return static_cast<long long>(header->trials);
+    }
+
+    // Returns the class (0 to NUM_CLASSES - 1) of a pair of hole cards
+    static int handClass(Card first, Card second) {
+        int high = first.rankIndex() > second.rankIndex() ? first.rankIndex() : second.rankIndex();
+        int low = first.rankIndex() > second.rankIndex() ? second.rankIndex() : first.rankIndex();
+        return first.suitIndex() == second.suitIndex() ? high * 13 + low : low * 13 + high;
+    }
+
+    // Returns the name of a class, such as "AA", "AKs" or "72o"
+    static std::string className(int handClass);
+
+    // Function to compute a table and write it to a file
+    //
+    // Parameters:
+    // - const string& path: The file to write; written to a temporary file first and renamed into place.
+    // - long long trials: Runouts to sample for every class and number of opponents.
+    // - uint64_t seed: Seed for the equity engine.
+    // - int numThreads: Threads to use, 0 for every core.
+    static void build(const std::string& path, long long trials, uint64_t seed, int numThreads = 0);
+
+    // Function to set the table the bots look preflop equities up in, nullptr for none
+    //
+    // Call it before any table starts playing; the table must outlive every game using it.
+    static void install(const PreflopTable* preflopTable);
+
+    static const PreflopTable* installed();
+
+private:
+    const char* data;
+    std::size_t length;
+    bool mapped;
+    std::vector<char> contents; // Holds the file when it could not be mapped
+    const PreflopHeader* header;
+    const float* table;
+
+    void release();
+};
+
+} // namespace poker
+
+#endif // POKER_PREFLOP_H
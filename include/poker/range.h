@@ -0,0 +1,119 @@
+#ifndef POKER_RANGE_H
+#define POKER_RANGE_H
+
+#include <cstdint>
+#include <string>
+
+#include "poker/card.h"
+
+namespace poker {
+
+// Class for a range of hole card combinations
+//
+// There are 1326 ways to hold two of the 52 cards. A range marks which of them a player might
+// hold, in a bitset, and how likely each is, as a weight; the combinations are numbered by
+// combo() so a range is two flat arrays with no allocation.
+//
+// parse() reads the usual notation, a comma separated list of:
+// - Pairs and hands: "AA", "AKs" (suited), "AKo" (offsuit), "AK" (both).
+// - Ranges: "TT+" (tens or better), "A2s+" (the kicker up to a King), "A5s-A2s", "99-66".
+// - Exact combinations: "AhKh".
+// Each item can end in ":weight", e.g. "AKo:0.5". Unknown notation throws invalid_argument.
+//
+// Methods:
+// - parse(), full(): Build a range.
+// - combo(), comboCards(): Map between hole cards and combination numbers.
+// - add(), remove(), contains(), weight(): Edit and read single combinations.
+// - removeCards(): Drops every combination holding a card known to be elsewhere.
+// - size(): The number of combinations in the range.
+class Range {
+public:
+    static const int NUM_COMBOS = 1326;
+
+    // Constructor for an empty range
+    Range();
+
+    static Range parse(const std::string& text);
+
+    // Returns the range of every combination, all with weight 1
+    static Range full();
+
+    // Returns the number (0-1325) of a pair of distinct cards, in either order
+    static int combo(Card first, Card second) {
+        int high = first.code > second.code ? first.code : second.code;
+        int low = first.code > second.code ? second.code : first.code;
+        return high * (high - 1) / 2 + low;
+    }
+
+    // Function to find the cards of a combination
+    //
+    // Parameters:
+    // - int combo: The combination number.
+    // - Card& first, Card& second: Receive the lower and the higher card.
+    static void comboCards(int combo, Card& first, Card& second);
+
+    void add(int combo, float comboWeight = 1.0f) {
+        bits[combo >> 6] |= 1ULL << (combo & 63);
+        weights[combo] = comboWeight;
+    }
+
+    void remove(int combo) {
+        bits[combo >> 6] &= ~(1ULL << (combo & 63));
+        weights[combo] = 0;
+    }
+
+    bool contains(int combo) const {
+        return (bits[combo >> 6] >> (combo & 63)) & 1;
+    }
+
+    float weight(int combo) const {
+        return weights[combo];
+    }
+
+    void removeCards(const Card cards[], int numCards);
+
+    int size() const;
+
+private:
+    static const int WORDS = (NUM_COMBOS + 63) / 64;
+
+    uint64_t bits[WORDS];
+    float weights[NUM_COMBOS];
+};
+
+// Struct holding the outcome of a range against range calculation
+//
+// Members:
+// - double win, tie, equity: The first range's chance to win, to split and its share of the pot.
+// - long long boards: The number of boards the result is based on.
+struct RangeEquityResult {
+    double win = 0;
+    double tie = 0;
+    double equity = 0;
+    long long boards = 0;
+};
+
+// Function to compute the equity of one range against another
+//
+// Every pair of combinations that share no card, with each other or the board, is weighted by
+// the product of their weights. On the river the pairs are not visited one by one: both ranges
+// are sorted by hand value and swept once, and the combinations a hand blocks are taken back out
+// with running totals per card, so a full range against a full range costs about one evaluation
+// and one sort per combination. Earlier boards are completed every possible way when there are
+// at most maxBoards completions, and otherwise maxBoards random completions are sampled.
+//
+// Parameters:
+// - const Range& hero, const Range& villain: The two ranges.
+// - const Card communityCards[]: The community cards dealt so far.
+// - int communitySize: The number of community cards (0 to 5).
+// - long long maxBoards: The most board completions to evaluate.
+// - uint64_t seed: Seed for sampling completions.
+//
+// Returns:
+// - RangeEquityResult: The hero range's win, tie and equity; all 0 if no pair of hands fits.
+RangeEquityResult rangeEquity(const Range& hero, const Range& villain, const Card communityCards[], int communitySize,
+                              long long maxBoards = 2000, uint64_t seed = 0);
+
+} // namespace poker
+
+#endif // POKER_RANGE_H
@@ -0,0 +1,160 @@
+#ifndef POKER_RANKINGS_H
+#define POKER_RANKINGS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "poker/player.h"
+#include "poker/rng.h"
+
+namespace poker {
+
+// Function to store and print player statistics in a hash table
+//
+// This function uses an unordered_map to store each player's name as the key
+// and a pair containing their games won and chip count as the value.
+//
+// Parameters:
+// - Player players[]: Array of players participating in the game.
+// - int numPlayers: The total number of players in the game.
+//
+// Methods:
+// - playerStats(Player players[], int numPlayers):
+//     Loops through each player and stores their statistics in the hash table.
+//     Displays the statistics
+void playerStats(Player players[], int numPlayers);
+
+// Function to rank players by chip count without moving them
+//
+// Sorts a compact array of (chips, seat) keys instead of the players, so the players stay in
+// their seats and nothing is copied or allocated. Players with equal chips keep their seat order.
+//
+// Parameters:
+// - const Player players[]: The players, at most MAX_PLAYERS.
+// - int numPlayers: The number of players.
+// - int order[]: Receives the seats from the most chips to the fewest.
+void rankPlayers(const Player players[], int numPlayers, int order[]);
+
+// Class for a leaderboard of players ranked by chips
+//
+// Players are keyed by an id (Player::id at a table, or any 32-bit number for a ladder, ids need
+// not be dense) and ranked by chips, most first, with the lower id first among equal stacks. The
+// board is an order-statistic treap: a binary search tree balanced by random priorities in which
+// every node also counts the nodes below it, so a change of chips, the rank of a player and the
+// player at a rank all take O(log n) and the top k take O(k + log n). Nodes sit in one array and
+// link by index, and an open-addressing hash table maps ids to nodes, so the board owns all its
+// memory, takes memory in proportion to its players whatever their ids and, once a player is on
+// it, updating their chips never allocates.
+//
+// Methods:
+// - update(): Sets a player's chips, adding them if needed.
+// - remove(), contains(): Take a player off and check whether one is on.
+// - chips(), rank(), at(): Look players up by id or by rank.
+// - top(): The leading players, in order.
+// - size(), clear(): The number of players and emptying the board.
+class Leaderboard {
+public:
+    // Struct for a player on the board
+    struct Entry {
+        uint32_t player;
+        long long chips;
+    };
+
+    Leaderboard() : root(NONE) {}
+
+    void update(uint32_t player, long long chips);
+
+    void remove(uint32_t player);
+
+    bool contains(uint32_t player) const {
+        return nodeOf(player) != NONE;
+    }
+
+    // Returns a player's chips; throws out_of_range if the player is not on the board
+    long long chips(uint32_t player) const {
+        return nodes[nodeOn(player)].chips;
+    }
+
+    // Returns a player's rank, 1 for the chip leader; throws out_of_range if the player is not on the board
+    std::size_t rank(uint32_t player) const;
+
+    // Returns the player at a rank, from 1 to size()
+    Entry at(std::size_t rank) const;
+
+    // Returns the first count players, chip leader first
+    std::vector<Entry> top(std::size_t count) const;
+
+    std::size_t size() const {
+        return root == NONE ? 0 : nodes[root].size;
+    }
+
+    void clear();
+
+private:
+    static constexpr int32_t NONE = -1;
+
+    // Struct for a node of the treap
+    struct Node {
+        long long chips;
+        uint32_t player;
+        uint32_t priority;
+        uint32_t size;
+        int32_t left;
+        int32_t right;
+    };
+
+    // Returns whether node a ranks ahead of node b
+    bool ahead(int32_t a, int32_t b) const {
+        return nodes[a].chips != nodes[b].chips ? nodes[a].chips > nodes[b].chips : nodes[a].player < nodes[b].player;
+    }
+
+    uint32_t sizeOf(int32_t node) const {
+        return node == NONE ? 0 : nodes[node].size;
+    }
+
+    void pull(int32_t node) {
+        nodes[node].size = 1 + sizeOf(nodes[node].left) + sizeOf(nodes[node].right);
+    }
+
+    // Struct for a slot of the id -> node table, empty when node is NONE
+    struct Slot {
+        uint32_t player;
+        int32_t node;
+    };
+
+    std::size_t home(uint32_t player) const {
+        return static_cast<std::size_t>(Rng::splitMix(player)) & (slots.size() - 1);
+    }
+
+    int32_t nodeOf(uint32_t player) const;
+
+    // Returns a player's node, throwing out_of_range if the player is not on the board
+    int32_t nodeOn(uint32_t player) const;
+    void mapInsert(uint32_t player, int32_t node);
+    void mapErase(uint32_t player);
+
+    void split(int32_t node, int32_t key, int32_t& before, int32_t& rest);
+    int32_t join(int32_t before, int32_t after);
+    void insertNode(int32_t node);
+    void eraseNode(int32_t node);
+
+    std::vector<Node> nodes;
+    std::vector<Slot> slots;        // Player id -> node, linear probing; a power of two, at most half full
+    std::vector<int32_t> freeNodes; // Nodes of players taken off, for reuse
+    int32_t root;
+};
+
+// Function to display a leaderboard of the players at a table
+//
+// Prints the players in rank order with their chips.
+//
+// Parameters:
+// - const Leaderboard& leaderboard: The board, keyed by Player::id.
+// - const Player players[]: The players, to find each id's name.
+// - int numPlayers: The number of players.
+void displayRankings(const Leaderboard& leaderboard, const Player players[], int numPlayers);
+
+} // namespace poker
+
+#endif // POKER_RANKINGS_H
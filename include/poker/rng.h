@@ -0,0 +1,93 @@
+#ifndef POKER_RNG_H
+#define POKER_RNG_H
+
+#include <cstdint>
+
+namespace poker {
+
+// Class for the random number generator used by the engine
+//
+// A xoshiro256** generator: 32 bytes of state, a few cycles per number and good statistical
+// quality. Each table or thread owns one, seeded once, so there is no shared state, no system
+// call per hand and the same seed always replays the same stream. It meets the standard
+// UniformRandomBitGenerator requirements and can be passed to <random> and <algorithm>.
+//
+// Methods:
+// - Rng(uint64_t seed): Seeds the generator.
+// - next(): Returns the next 64 random bits.
+// - below(): Returns a uniform integer in [0, n).
+// - uniform(): Returns a uniform double in [0, 1).
+// - splitMix(): Scrambles a value into a well-mixed 64-bit seed.
+// - randomSeed(): Draws a fresh seed from the operating system.
+class Rng {
+public:
+    using result_type = uint64_t;
+
+    explicit Rng(uint64_t seedValue = 0) {
+        seed(seedValue);
+    }
+
+    // Function to restart the generator from a seed
+    void seed(uint64_t seedValue) {
+        for (uint64_t& word : state) {
+            seedValue += 0x9E3779B97F4A7C15ULL;
+            word = splitMix(seedValue);
+        }
+    }
+
+    uint64_t next() {
+        uint64_t result = rotateLeft(state[1] * 5, 7) * 9;
+        uint64_t shifted = state[1] << 17;
+        state[2] ^= state[0];
+        state[3] ^= state[1];
+        state[1] ^= state[2];
+        state[0] ^= state[3];
+        state[2] ^= shifted;
+        state[3] = rotateLeft(state[3], 45);
+        return result;
+    }
+
+    // Function to draw a uniform integer in [0, n) without modulo bias (Lemire's method)
+    uint32_t below(uint32_t n) {
+        uint64_t product = (next() >> 32) * n;
+        uint32_t low = static_cast<uint32_t>(product);
+        if (low < n) {
+            uint32_t threshold = (0u - n) % n;
+            while (low < threshold) {
+                product = (next() >> 32) * n;
+                low = static_cast<uint32_t>(product);
+            }
+        }
+        return static_cast<uint32_t>(product >> 32);
+    }
+
+    // Function to draw a uniform double in [0, 1) from the top 53 bits
+    double uniform() {
+        return static_cast<double>(next() >> 11) * (1.0 / 9007199254740992.0);
+    }
+
+    uint64_t operator()() { return next(); }
+    static constexpr uint64_t min() { return 0; }
+    static constexpr uint64_t max() { return ~0ULL; }
+
+    // SplitMix64 finalizer, spreads a value over all 64 bits
+    static uint64_t splitMix(uint64_t x) {
+        x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+        return x ^ (x >> 31);
+    }
+
+    // Function to draw a seed from the operating system, for sessions without a fixed seed
+    static uint64_t randomSeed();
+
+private:
+    uint64_t state[4];
+
+    static uint64_t rotateLeft(uint64_t x, int bits) {
+        return (x << bits) | (x >> (64 - bits));
+    }
+};
+
+} // namespace poker
+
+#endif // POKER_RNG_H
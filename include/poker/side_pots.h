@@ -0,0 +1,106 @@
+#ifndef POKER_SIDE_POTS_H
+#define POKER_SIDE_POTS_H
+
+#include <cstdint>
+
+#include "poker/action_log.h"
+#include "poker/card.h"
+#include "poker/player.h"
+
+namespace poker {
+
+// Struct for one pot of a hand
+//
+// Members:
+// - int amount: Chips in the pot.
+// - int level: The contribution a player needed to make to be in it.
+// - uint8_t eligible: Bit i is set if seat i can win the pot.
+// - uint8_t winners: Bit i is set if seat i won (a share of) the pot, filled in by award().
+// - uint8_t contributors: Bit i is set if seat i put chips in the pot. A pot with one contributor
+//   is a bet nobody called, handed back rather than won.
+struct Pot {
+    int amount;
+    int level;
+    uint8_t eligible;
+    uint8_t winners;
+    uint8_t contributors;
+};
+
+// Class for the chips put in during a hand and the pots they make up
+//
+// Records every seat's contribution street by street. When the hand is over build() layers the
+// chips into a main pot and side pots: each distinct all-in amount of a player still in the
+// hand caps a pot, and only players who put in at least that much can win it. Folded players'
+// chips stay in the pots they paid into. award() then pays each pot to the best eligible hand.
+// Everything lives in fixed arrays over the seats, so the showdown never allocates.
+//
+// Methods:
+// - reset(): Empties the contributions for a new hand.
+// - contribute(): Records chips a seat put in on a street.
+// - contributed(), total(): Read the contributions.
+// - build(): Layers the contributions into pots.
+// - award(): Pays the pots out.
+// - size(), operator[]: Read the pots, main pot first.
+class SidePots {
+public:
+    SidePots() {
+        reset(0);
+    }
+
+    void reset(int numSeats);
+
+    void contribute(int seat, Street street, int chips) {
+        byStreet[street][seat] += chips;
+        byHand[seat] += chips;
+    }
+
+    int contributed(int seat, Street street) const {
+        return byStreet[street][seat];
+    }
+
+    int contributed(int seat) const {
+        return byHand[seat];
+    }
+
+    // Chips put in by every seat together
+    int total() const;
+
+    // Function to layer the contributions into a main pot and side pots
+    //
+    // Parameters:
+    // - const Player players[]: The players, to tell who is still in the hand.
+    //
+    // Returns:
+    // - int: The number of pots.
+    int build(const Player players[]);
+
+    // Function to pay out the pots
+    //
+    // Each pot goes to the eligible seat with the highest score. Tied seats split it evenly and
+    // the odd chips go one each to the tied seats in order, starting left of the button.
+    //
+    // Parameters:
+    // - const int scores[]: Each seat's hand value, higher is better.
+    // - int button: The seat of the dealer button.
+    // - int payouts[]: Filled with the chips won by each seat.
+    void award(const int scores[], int button, int payouts[]);
+
+    int size() const {
+        return numPots;
+    }
+
+    const Pot& operator[](int index) const {
+        return pots[index];
+    }
+
+private:
+    int seats;
+    int byStreet[4][MAX_PLAYERS]; // Chips put in by each seat on each street
+    int byHand[MAX_PLAYERS];      // Chips put in by each seat over the hand
+    Pot pots[MAX_PLAYERS];
+    int numPots;
+};
+
+} // namespace poker
+
+#endif // POKER_SIDE_POTS_H
@@ -0,0 +1,116 @@
+#ifndef POKER_SIMULATION_H
+#define POKER_SIMULATION_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "poker/card.h"
+#include "poker/game.h"
+#include "poker/interaction_store.h"
+
+namespace poker {
+
+// Class for a work-stealing thread pool
+//
+// Every worker owns a queue of tasks. Workers take new work from the back of their own queue
+// and, when it is empty, steal from the front of the other workers' queues, so long and short
+// tasks even out across cores without a single shared queue becoming a bottleneck. An exception
+// thrown by a task is caught by its worker, which carries on, and the first one is rethrown by
+// wait().
+//
+// Methods:
+// - ThreadPool(int numThreads): Starts the workers, 0 for one per core.
+// - submit(): Queues a task.
+// - wait(): Blocks until every submitted task has finished, then rethrows the first exception a task threw.
+// - size(): The number of worker threads.
+class ThreadPool {
+public:
+    explicit ThreadPool(int numThreads = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // Function to queue a task, spreading tasks over the workers' queues in turn
+    void submit(std::function<void()> task);
+
+    // Function to block until every submitted task has finished
+    //
+    // If any task threw since the last wait(), rethrows the first exception, once every task is done.
+    void wait();
+
+    int size() const {
+        return static_cast<int>(workers.size());
+    }
+
+private:
+    struct WorkQueue {
+        std::mutex lock;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    std::vector<std::unique_ptr<WorkQueue>> queues;
+    std::vector<std::thread> workers;
+    std::mutex sleepLock;
+    std::condition_variable wake;  // Signalled when a task is queued or the pool stops
+    std::condition_variable idle;  // Signalled when the last pending task finishes
+    bool stopping;
+    long long queued;                  // Tasks sitting in a queue, guarded by sleepLock
+    std::atomic<long long> pending;    // Tasks queued or running
+    std::atomic<std::size_t> nextQueue;
+    std::exception_ptr error;          // The first exception a task threw, guarded by sleepLock
+
+    bool takeTask(int self, std::function<void()>& task);
+    void workerLoop(int self);
+};
+
+// Struct holding the combined results of a batch of simulated tables
+//
+// Members:
+// - int numBots: The number of bots seated at every table ("Bot 1" to "Bot n").
+// - long long tables, hands: The number of tables and hands played in total.
+// - long long chips[MAX_PLAYERS]: Chips each bot finished with, summed over the tables.
+// - long long handsWon[MAX_PLAYERS]: Hands each bot won, summed over the tables.
+// - long long tablesWon[MAX_PLAYERS]: Tables each bot finished as chip leader.
+// - double seconds: Wall-clock time of the batch.
+struct BatchResult {
+    int numBots = 0;
+    long long tables = 0;
+    long long hands = 0;
+    long long chips[MAX_PLAYERS] = {};
+    long long handsWon[MAX_PLAYERS] = {};
+    long long tablesWon[MAX_PLAYERS] = {};
+    double seconds = 0;
+};
+
+// Function to simulate many independent bot tables in parallel
+//
+// Every table gets its own Deck, players and InterGraph and runs gameLoop headless as one task
+// on a ThreadPool. Results are kept per table and summed once every table is done, so the
+// workers never share state. If a table fails, the other tables still finish and then a
+// runtime_error naming the table is thrown.
+//
+// Parameters:
+// - int numTables: The number of tables to play.
+// - int numBots: Bots seated at each table (2 to MAX_PLAYERS).
+// - const GameOptions& options: The hand or time budget of each table (headless is forced on).
+//   Table t is seeded from (options.seed, t), so a batch seed replays every table.
+// - int numThreads: Worker threads, 0 for one per core.
+// - InteractionStore* interactionStore: Where each table's interactions are appended as a session, if anywhere.
+//
+// Returns:
+// - BatchResult: The totals per bot across all tables.
+BatchResult simulateTables(int numTables, int numBots, const GameOptions& options, int numThreads = 0,
+                           InteractionStore* interactionStore = nullptr);
+
+} // namespace poker
+
+#endif // POKER_SIMULATION_H
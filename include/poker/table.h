@@ -0,0 +1,223 @@
+#ifndef POKER_TABLE_H
+#define POKER_TABLE_H
+
+#include <cstdint>
+
+#include "poker/action_log.h"
+#include "poker/card.h"
+#include "poker/cfr.h"
+#include "poker/deck.h"
+#include "poker/player.h"
+#include "poker/rng.h"
+#include "poker/side_pots.h"
+
+namespace poker {
+
+// Struct for an action submitted to a Table
+//
+// Members:
+// - ActionType type: What the player does. Bluff is a bet or raise that is logged as a bluff.
+// - int amount: For bets and raises, the total the player's bet on this street is raised to.
+//   Ignored for calls, checks and folds.
+struct Action {
+    ActionType type;
+    int amount;
+};
+
+// Struct for a decision point: the state a player sees when it is their turn
+//
+// Members:
+// - int seat: The seat to act, or -1 once the hand is over.
+// - Street street: The street being bet on.
+// - int pot: Chips in the pot, including this street's bets.
+// - int currentBet: The largest bet on this street.
+// - int toCall: Chips the seat must put in to call (may exceed its stack, calling is then all-in).
+// - int minRaise, maxRaise: The smallest legal total for a bet or raise, and the seat's all-in total.
+// - int raises: Bets and raises made on this street so far, blinds excluded.
+// - uint8_t legal: Bit (1 << ActionType) is set for every action the seat may take.
+struct Decision {
+    int seat;
+    Street street;
+    int pot;
+    int currentBet;
+    int toCall;
+    int minRaise;
+    int maxRaise;
+    int raises;
+    uint8_t legal;
+
+    bool canTake(ActionType type) const {
+        return (legal >> static_cast<int>(type)) & 1;
+    }
+};
+
+// Class for the state machine of a table playing one hand at a time
+//
+// A Table never blocks and never asks anyone for input. startHand() deals a hand and posts the
+// blinds, then apply() takes the action of the seat to act and returns the next decision point.
+// Streets are dealt, betting rounds closed and the pot awarded inside apply(), so whoever drives
+// the table (a bot, the console, a network client or a replay file) only ever answers decisions.
+// Nothing is allocated, so many tables can be stepped in turn on one thread.
+//
+// The players stay owned by the caller and must not move while a hand is in progress.
+// Illegal actions throw invalid_argument and leave the table unchanged.
+//
+// Methods:
+// - startHand(): Shuffles, deals and posts the blinds.
+// - apply(): Plays the seat to act's action.
+// - decision(), handOver(): The current decision point.
+// - board(), boardSize(), actions(), player(), numPlayers(): Read the hand so far.
+// - winner(), potWon(), payout(), won(), pots(): The result once the hand is over.
+// - rng(): The hand's random number generator, for bot decisions.
+class Table {
+public:
+    static const int SMALL_BLIND = 10;
+    static const int BIG_BLIND = 20;
+
+    explicit Table(Deck& deck);
+
+    // Function to start a new hand
+    //
+    // Parameters:
+    // - Player players[]: The players dealt in. Players with no chips sit the hand out folded.
+    // - int numPlayers: The number of players.
+    // - int button: The seat of the dealer button; the next two seats post the blinds
+    //   (heads-up, the button posts the small blind).
+    // - uint64_t seed: Seed for the hand's deal and bot decisions.
+    //
+    // Returns:
+    // - const Decision&: The first decision of the hand.
+    const Decision& startHand(Player players[], int numPlayers, int button, uint64_t seed);
+
+    // Function to play the action of the seat to act
+    //
+    // Closes the betting round once every player still able to bet has acted and matched the
+    // current bet, dealing the next street; when one player is left or nobody can bet any more
+    // the rest of the board is dealt and the main and side pots go to the best eligible hands.
+    //
+    // Parameters:
+    // - const Action& action: The action. A bet or raise above the player's stack goes all-in.
+    //
+    // Returns:
+    // - const Decision&: The next decision, with seat -1 if the hand is over.
+    const Decision& apply(const Action& action);
+
+    const Decision& decision() const {
+        return current;
+    }
+
+    bool handOver() const {
+        return current.seat < 0;
+    }
+
+    const Card* board() const {
+        return communityCards;
+    }
+
+    int boardSize() const {
+        return communitySize;
+    }
+
+    const ActionLog& actions() const {
+        return actionLog;
+    }
+
+    Player& player(int seat) const {
+        return players[seat];
+    }
+
+    int numPlayers() const {
+        return seats;
+    }
+
+    // Number of players who have not folded
+    int activePlayers() const;
+
+    // Whether a seat was dealt into the hand rather than sitting it out with no chips
+    bool dealtIn(int seat) const {
+        return dealt[seat];
+    }
+
+    // Seat that won the most chips, or -1 while the hand is in progress
+    int winner() const {
+        return winningSeat;
+    }
+
+    // Chips in all the pots together at the end of the hand
+    int potWon() const {
+        return awarded;
+    }
+
+    // Chips a seat won at the end of the hand, including any uncalled bet handed back
+    int payout(int seat) const {
+        return payouts[seat];
+    }
+
+    // Whether a seat won or split a pot that someone else also paid into
+    bool won(int seat) const {
+        return (wonPots >> seat & 1) != 0;
+    }
+
+    // The chips put in during the hand, layered into pots once the hand is over
+    const SidePots& pots() const {
+        return sidePots;
+    }
+
+    Rng& rng() {
+        return handRng;
+    }
+
+private:
+    Deck& deck;
+    Rng handRng;
+    ActionLog actionLog;
+    Player* players;
+    int seats;
+    int button;
+    Card communityCards[5];
+    int communitySize;
+    SidePots sidePots;           // Chips each seat has put in, street by street
+    bool toAct[MAX_PLAYERS];     // Seats that still have to act before the street closes
+    bool mayRaise[MAX_PLAYERS];  // Seats the betting is open to; false once a seat has acted and only a short all-in followed
+    bool dealt[MAX_PLAYERS];     // Seats that had chips when the hand started
+    int lastRaise;               // Size of the last bet or raise, the minimum for the next one
+    int payouts[MAX_PLAYERS];    // Chips each seat won at the end of the hand
+    int winningSeat;
+    uint8_t wonPots;             // Seats that won or split a pot someone else paid into
+    int awarded;
+    Decision current;
+
+    int nextSeat(int seat) const;
+    bool canBet(int seat) const;
+    void postBlind(int seat, int amount);
+    void startStreet(Street street);
+    void advance(int from);
+    void finishHand();
+    void updateDecision(int seat);
+};
+
+// Function to choose a bot's action
+//
+// With a trained strategy, the bot looks up its information set (see Strategy) and draws an action
+// from it, raising by the abstraction's bet unit. Its hand strength bucket comes from its equity
+// against the players left, converted to a heads-up strength.
+//
+// Without one, bots bet or raise with three of a kind or better, or when their estimated equity is
+// well above an even share of the pot, and otherwise pick at random between raising, calling,
+// folding and a small bluff. Folding is replaced by checking when there is nothing to call, and
+// bots stop raising after two raises on a street.
+//
+// Equity is estimated against random hands, except heads-up on the river, where it is computed
+// exactly against a range: any two cards, or a tighter range if the opponent bet or raised.
+//
+// Parameters:
+// - Table& table: The table, whose seat to act is a bot.
+// - const Strategy* strategy: The strategy trained by CfrTrainer, or nullptr for the built-in rules.
+//
+// Returns:
+// - Action: A legal action for the seat to act.
+Action botAction(Table& table, const Strategy* strategy = nullptr);
+
+} // namespace poker
+
+#endif // POKER_TABLE_H
@@ -8,996 +8,804 @@
     *-Play Poker by yourself or with friends against Bots.
     * Bet chips and choose your action on each turn carefully
     * the player with the best hand wins
+    *
+    * This file is the console front end. The game itself is the poker engine
+    * library (include/poker, src), shared with the benchmark and any other tools.
     *
      */
-#include <iostream>
-#include <string>
 #include <algorithm>
-#include <cstdlib>
+#include <cctype>
+#include <chrono>
 #include <ctime>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <limits>
 #include <map>
-#include <list>
-#include <queue>
-#include <set>
-#include <iterator>
-#include <numeric>
-#include <stack>
+#include <memory>
+#include <stdexcept>
+#include <string>
 #include <thread>
-#include <chrono>
-#include <sstream>
-#include <fstream>
-#include <array>
-#include <random>
-#include <functional> 
 
-using namespace std;
+#include "poker/engine.h"
 
-// Constants representing maximum players and cards in the deck
-//
-// MAX_PLAYERS: The maximum number of players that can participate in the game.
-// MAX_CARDS: The total number of cards in a deck.
+using namespace std;
+using namespace poker;
 
-const int MAX_PLAYERS = 6;
-const int MAX_CARDS = 52;
+// Where the preflop equity table is built and looked for at startup
+const char* const PREFLOP_TABLE_PATH = "preflop_equity.bin";
 
-// Class representing a playing card
-//
-// Stores the suit and rank of a card. Used to create the deck and deal cards to players.
+// Function to read the value given to --seed
 //
-// Members:
-// - string suit: The suit of the card (e.g., Hearts, Spades).
-// - string rank: The rank of the card (e.g., Ace, King, 2).
+// Throws invalid_argument with a usage message unless the text is a whole number that fits in 64 bits.
 //
-// Constructors:
-// - Card(): Initializes the card to empty values for suit and rank.
-// - Card(string cardRank, string cardSuit): Initializes the card with specific rank and suit.
-class Card {
-public:
-    string suit; // The suit of the card (e.g., Hearts, Spades)
-    string rank; // The rank of the card (e.g., Ace, King, 2)
-
-    // Default constructor initializing the card to empty values
-    Card() : suit(""), rank("") {}
-
-    // Parameterized constructor to initialize card with specific rank and suit
-    Card(string cardRank, string cardSuit) : rank(cardRank), suit(cardSuit) {}
-};
-
-// Class representing a deck of cards
-//
-// The deck contains all 52 cards used in the game. It allows shuffling and dealing cards to players.
-//
-// Members:
-// - Card cards[MAX_CARDS]: Array of Card objects representing the deck.
-// - int topCardIndex: Index of the top card to be dealt, which keeps track of dealt cards.
+// Parameters:
+// - const string& text: The value, as typed.
 //
-// Methods:
-// - Deck(): Initializes the deck with all 52 cards (13 ranks for each of the 4 suits).
-// - shuffle(): Shuffles the deck to randomize the order of cards.
-// - dealCard(): Deals the top card from the deck to a player.
-class Deck {
-public:
-    Card cards[MAX_CARDS]; // Array of Card objects representing the deck
-    int topCardIndex; // Index of the top card to be dealt
-
-    // Constructor initializing the deck with all cards
-    Deck() : topCardIndex(0) {
-        string suits[] = { "Hearts", "Diamonds", "Clubs", "Spades" };
-        string ranks[] = { "2", "3", "4", "5", "6", "7", "8", "9", "10", "Jack", "Queen", "King", "Ace" };
-        int index = 0;
-
-        // Populate the deck with cards of each rank and suit
-        for (const auto& suit : suits) {
-            for (const auto& rank : ranks) {
-                cards[index++] = Card(rank, suit);
-            }
+// Returns:
+// - uint64_t: The seed.
+uint64_t parseSeed(const string& text) {
+    size_t used = 0;
+    uint64_t seed = 0;
+    if (!text.empty() && isdigit(static_cast<unsigned char>(text[0]))) {
+        try {
+            seed = stoull(text, &used);
+        }
+        catch (const out_of_range&) {
+            used = 0;
         }
     }
-
-    // Function to shuffle the deck using std::shuffle 
-    // Randomizes the order of cards in the deck so that players get unpredictable cards.
-    void shuffle() {
-        random_device rd;
-        mt19937 g(static_cast<unsigned int>(rd()));
-        std::shuffle(cards, cards + MAX_CARDS, g);
+    if (used == 0 || used != text.size()) {
+        throw invalid_argument("Usage: --seed <n>, where n is a whole number below 2^64, not \"" + text + "\".");
     }
+    return seed;
+}
 
-    // Function to deal the top card from the deck
-    // Returns the card at the top of the deck and increments the top card index.
-    // Throws an exception if no cards are left in the deck.
-    Card dealCard() {
-        if (topCardIndex < MAX_CARDS) {
-            return cards[topCardIndex++];
+// Function to run a headless bot-only simulation from the command line
+//
+// Usage: --simulate [--hands <n>] [--seconds <t>] [--bots <n>] [--tables <n>] [--threads <n>] [--seed <n>] [--history <file>]
+//        [--strategy <file>] [--interactions <dir>]
+// Plays all-bot tables with no output until each table's budget runs out or one bot has every chip,
+// then prints the throughput and the chips per bot. With more than one table the tables run in
+// parallel (see simulateTables) and the hand and time budgets apply to each table. --history
+// appends every hand played to a binary hand history file (see HandHistoryWriter). --strategy
+// has the bots play a strategy written by --train. --interactions appends each table's interactions
+// to an interaction store (see InteractionStore). Also prints the equity cache's hit rate.
+//
+// Parameters:
+// - int argc, char* argv[]: The command line arguments, starting with --simulate.
+//
+// Returns:
+// - int: The process exit code.
+int runSimulation(int argc, char* argv[]) {
+    GameOptions options;
+    options.headless = true;
+    int numBots = MAX_PLAYERS;
+    int numTables = 1;
+    int numThreads = 0;
+    string historyPath;
+    unique_ptr<HandHistoryWriter> history;
+    unique_ptr<InteractionStore> interactionStore;
+    Strategy strategy;
+
+    try {
+        for (int i = 2; i < argc; ++i) {
+            string arg = argv[i];
+            bool hasValue = i + 1 < argc;
+            if (arg == "--hands" && hasValue) {
+                options.maxHands = stoll(argv[++i]);
+            }
+            else if (arg == "--seconds" && hasValue) {
+                options.maxSeconds = stod(argv[++i]);
+            }
+            else if (arg == "--bots" && hasValue) {
+                numBots = stoi(argv[++i]);
+            }
+            else if (arg == "--tables" && hasValue) {
+                numTables = stoi(argv[++i]);
+            }
+            else if (arg == "--threads" && hasValue) {
+                numThreads = stoi(argv[++i]);
+            }
+            else if (arg == "--seed" && hasValue) {
+                options.seed = parseSeed(argv[++i]);
+            }
+            else if (arg == "--history" && hasValue) {
+                historyPath = argv[++i];
+            }
+            else if (arg == "--strategy" && hasValue) {
+                strategy.load(argv[++i]);
+                options.strategy = &strategy;
+            }
+            else if (arg == "--interactions" && hasValue) {
+                interactionStore.reset(new InteractionStore(argv[++i]));
+            }
+            else {
+                throw invalid_argument("Unexpected argument: " + arg);
+            }
         }
-        else {
-            throw runtime_error("No cards left in the deck.");
+        if (numBots < 2 || numBots > MAX_PLAYERS) {
+            throw invalid_argument("A table seats 2 to " + to_string(MAX_PLAYERS) + " bots.");
+        }
+        if (numTables < 1) {
+            throw invalid_argument("At least one table is needed.");
+        }
+        if (options.maxHands <= 0 && options.maxSeconds <= 0) {
+            options.maxHands = 10000;
+        }
+        if (!historyPath.empty()) {
+            history.reset(new HandHistoryWriter(historyPath));
+            options.history = history.get();
         }
     }
+    catch (const exception& e) {
+        cout << e.what() << endl;
+        return 1;
+    }
 
-    // Function to reset the deck
-    // Resets the deck by setting the top card index back to 0.
-    void reset() {
-        topCardIndex = 0;
+    BatchResult batch;
+    try {
+        batch = simulateTables(numTables, numBots, options, numThreads, interactionStore.get());
+        if (history) history->close();
     }
-};
-// Class for the Interactions Graph
-//
-// Tracks interactions between players, storing their names as nodes and chips exchanged as weights on edges.
-class InterGraph {
-public:
-    unordered_map<string, vector<pair<string, int>>> adjList; // Player -> {Neighbor, Chips Exchanged}
-
-    // Add an interaction between two players
-    //
-    // Parameters:
-    // - string player1: The first player's name.
-    // - string player2: The second player's name.
-    // - int chips: The number of chips exchanged in the interaction.
-    void addInter(string player1, string player2, int chips) {
-        adjList[player1].push_back({player2, chips}); // Add an edge for player1 -> player2
-        adjList[player2].push_back({player1, chips}); // Add an edge for player2 -> player1 (mutual)
+    catch (const exception& e) {
+        cout << e.what() << endl;
+        return 1;
     }
 
-    // Display all interactions in the graph
-    //
-    // Prints each player and their interactions with other players.
-    void display() {
-        cout << "\nPlayer Interactions:\n";
-        for (auto& [player, interactions] : adjList) {
-            cout << player << " interacted with:\n";
-            for (auto& [neighbor, chips] : interactions) {
-                cout << "  - " << neighbor << " (Chips: " << chips << ")\n";
-            }
-        }
+    cout << batch.tables << " tables, " << batch.hands << " hands in " << batch.seconds << " s ("
+         << static_cast<long long>(batch.hands / max(batch.seconds, 1e-9)) << " hands/sec)\n";
+    for (int i = 0; i < batch.numBots; ++i) {
+        cout << "Bot " << (i + 1) << " -> Chips: " << batch.chips[i] << ", Hands Won: " << batch.handsWon[i]
+             << ", Tables Won: " << batch.tablesWon[i] << endl;
     }
-
-    // Reset the graph (clear all interactions)
-    void reset() {
-        adjList.clear();
+    const EquityCache* equityCache = EquityCache::installed();
+    if (equityCache) {
+        uint64_t lookups = equityCache->hits() + equityCache->misses();
+        cout << "Equity cache: " << equityCache->hits() << " hits, " << equityCache->misses() << " misses ("
+             << 100.0 * equityCache->hits() / max<uint64_t>(1, lookups) << "% hit rate)" << endl;
+    }
+    if (history) {
+        cout << history->handsWritten() << " hands recorded to " << historyPath << endl;
+    }
+    if (interactionStore) {
+        cout << "Interaction store: " << interactionStore->hands() << " hands, " << interactionStore->players()
+             << " players, " << interactionStore->segments() << " segments" << endl;
     }
-};
+    return 0;
+}
 
-// Class representing a player in the game
-//
-// Stores information about each player, including their name, hand, chip count, and game statistics.
+// Function to query an interaction store from the command line
 //
-// Members:
-// - string name: The name of the player.
-// - Card hand[2]: Array storing the player's hand (2 cards).
-// - int chips: The number of chips the player currently has.
-// - bool folded: Indicates if the player has folded in the current round.
-// - int gamesWon: The number of games won by the player.
-// - int handsPlayed: The total number of hands played by the player.
-// - int handsWon: The total number of hands won by the player.
+// Usage: --query-interactions <dir> [--rivals <player>] [--top <n>] [--flow <player> <rival>] [--last <hands>] [--compact]
+// --rivals lists the players someone played the most hands with (10 unless --top says otherwise),
+// --flow shows the totals between two players and --last limits both to the most recent hands.
+// --compact merges the store into one segment first.
 //
-// Methods:
-// - Player(): Default constructor initializing player values.
-// - Player(string playerName): Initializes player with a specific name.
-// - takeAction(): Allows the player to take an action during betting.
-// - receiveCard(): Adds a card to the player's hand.
-// - showHand(): Displays the cards in the player's hand.
-// - evaluateHand(): Evaluates and returns a score for the player's hand.
-// - evaluateHandStrength(): Calculates hand strength based on community cards.
-// - savePlayerState(): Saves the player's state to a file.
-// - loadPlayerState(): Loads the player's state from a file.
-// - displayPlayerStatistics(): Displays the player's game statistics.
-
-class Player {
-public:
-    string name; // Player's name
-    Card hand[2]; // Array to store the player's hand (2 cards)
-    int chips; // Number of chips the player has
-    bool folded; // Whether the player has folded
-    int gamesWon; // Number of games won by the player
-    int handsPlayed; // Number of hands played by the player
-    int handsWon; // Number of hands won by the player
-
-    // Default constructor initializing player with default values
-    Player() : name(""), chips(1000), folded(false), gamesWon(0), handsPlayed(0), handsWon(0) {}
-
-    // Parameterized constructor initializing player with a specific name
-    Player(string playerName) : name(playerName), chips(1000), folded(false), gamesWon(0), handsPlayed(0), handsWon(0) {}
-
-    // Function for the player to take an action during betting
-    //
-    // Allows the player to take an action such as betting, calling, checking, or folding.
-    // Depending on whether the player is a bot or a human, the function handles decision-making differently.
-    //
-    // Parameters:
-    // - int& currentBet: The current highest bet that must be matched by all players.
-    // - int& pot: The total number of chips in the pot for the current round.
-    // - list<string>& actionHistory: A history of actions taken during the current round.
-    // - Card communityCards[]: The community cards visible to all players.
-    // - int communitySize: The number of community cards currently dealt
-
-    void takeAction(int& currentBet, int& pot, list<string>& actionHistory, Card communityCards[], int communitySize) {
-        if (folded) return; // If player has folded, skip their turn
-
-        if (name.find("Bot") != string::npos) {
-            // Bot AI logic - improved decision-making based on hand strength and community cards
-            int action = evaluateHandStrength(communityCards, communitySize) > 5 ? 0 : rand() % 4;  // Based on strength, choose action
-
-            switch (action) {
-            case 0: {
-                // Bot decides to bet or raise
-                int betAmount = min(50, chips); // Example bet amount
-                if (betAmount > currentBet) {
-                    currentBet = betAmount;
-                    chips -= betAmount;
-                    pot += betAmount;
-                    actionHistory.push_back(name + " raises to " + to_string(betAmount) + " chips.");
-                }
-                else {
-                    chips -= betAmount;
-                    pot += betAmount;
-                    actionHistory.push_back(name + " bets " + to_string(betAmount) + " chips.");
-                }
-                break;
+// Parameters:
+// - int argc, char* argv[]: The command line arguments, starting with --query-interactions.
+//
+// Returns:
+// - int: The process exit code.
+int runInteractionTool(int argc, char* argv[]) {
+    if (argc < 3) {
+        cout << "Usage: --query-interactions <dir> [--rivals <player>] [--top <n>] [--flow <player> <rival>] [--last <hands>] [--compact]" << endl;
+        return 1;
+    }
+    string rivalsOf, flowPlayer, flowRival;
+    int top = 10;
+    long long lastHands = 0;
+    bool compact = false;
+
+    try {
+        for (int i = 3; i < argc; ++i) {
+            string arg = argv[i];
+            bool hasValue = i + 1 < argc;
+            if (arg == "--rivals" && hasValue) {
+                rivalsOf = argv[++i];
             }
-            case 1:
-                // Bot decides to call or check
-                if (chips >= currentBet) {
-                    chips -= currentBet;
-                    pot += currentBet;
-                    actionHistory.push_back(name + " calls " + to_string(currentBet) + " chips.");
-                }
-                else {
-                    actionHistory.push_back(name + " checks.");
-                }
-                break;
-            case 2:
-                // Bot decides to fold
-                folded = true;
-                actionHistory.push_back(name + " folds.");
-                break;
-            case 3:
-                // Bot decides to bluff
-                if (chips >= currentBet + 20) {
-                    currentBet += 20;
-                    chips -= 20;
-                    pot += 20;
-                    actionHistory.push_back(name + " bluffs with " + to_string(20) + " chips.");
-                }
-                break;
+            else if (arg == "--top" && hasValue) {
+                top = stoi(argv[++i]);
+            }
+            else if (arg == "--flow" && i + 2 < argc) {
+                flowPlayer = argv[++i];
+                flowRival = argv[++i];
+            }
+            else if (arg == "--last" && hasValue) {
+                lastHands = stoll(argv[++i]);
+            }
+            else if (arg == "--compact") {
+                compact = true;
+            }
+            else {
+                throw invalid_argument("Unexpected argument: " + arg);
             }
         }
-        else {
-            // Human player logic
-            string action;
-            do {
-                cout << name << ", it's your turn. Enter your action (Bet, Raise, Call, Check, Fold): ";
-                cin >> action;
-
-                if (action == "Bet" || action == "Raise") {
-                    int betAmount;
-                    cout << "Enter bet amount: ";
-                    while (!(cin >> betAmount) || betAmount <= 0) {
-                        cout << "Invalid input. Please enter a valid positive bet amount: ";
-                        cin.clear();
-                        cin.ignore(numeric_limits<streamsize>::max(), '\n');
-                    }
-                    if (betAmount > chips) {
-                        cout << "You don't have enough chips. Betting all your chips instead." << endl;
-                        betAmount = chips;
-                    }
-                    if (betAmount > currentBet) {
-                        currentBet = betAmount;
-                    }
-                    chips -= betAmount;
-                    pot += betAmount;
-                    actionHistory.push_back(name + " bets " + to_string(betAmount) + " chips.");
-                }
-                else if (action == "Call") {
-                    if (chips >= currentBet) {
-                        chips -= currentBet;
-                        pot += currentBet;
-                        actionHistory.push_back(name + " calls " + to_string(currentBet) + " chips.");
-                    }
-                    else {
-                        cout << "You don't have enough chips to call." << endl;
-                    }
-                }
-                else if (action == "Check") {
-                    actionHistory.push_back(name + " checks.");
-                }
-                else if (action == "Fold") {
-                    folded = true;
-                    actionHistory.push_back(name + " folds.");
-                }
-                else {
-                    cout << "Invalid action. Please try again." << endl;
-                }
-            } while (action != "Bet" && action != "Raise" && action != "Call" && action != "Check" && action != "Fold");
-        }
-    }
-
-    // Function to receive a card
-    //
-    // Adds a card to the player's hand at the specified index.
-    //
-    // Parameters:
-    // - Card card: The card to be added to the player's hand.
-    // - int index: The index (0 or 1) to place the card in the player's hand.
-
-    void receiveCard(Card card, int index) {
-        if (index < 2) {
-            hand[index] = card;
-        }
-    }
 
-    // Function to display the player's hand
-    //
-    // Outputs the player's hand to the console, showing both cards.
+        InteractionStore store(argv[2]);
+        if (compact) store.compact();
+        cout << store.hands() << " hands, " << store.players() << " players, " << store.segments() << " segments" << endl;
+        string window = lastHands > 0 ? " over the last " + to_string(lastHands) + " hands" : "";
 
-    void showHand(bool hideCards = false) {
-        if (hideCards) {
-            cout << name << "'s hand: [Hidden]" << endl;
-        }
-        else {
-            cout << name << "'s hand: ";
-            for (int i = 0; i < 2; ++i) {
-                cout << hand[i].rank << " of " << hand[i].suit << (i == 1 ? "" : ", ");
+        auto start = chrono::steady_clock::now();
+        if (!rivalsOf.empty()) {
+            vector<InteractionStore::Rival> rivals = store.topRivals(rivalsOf, top, lastHands);
+            cout << "Top rivals of " << rivalsOf << window << ":\n";
+            for (const InteractionStore::Rival& rival : rivals) {
+                cout << "  " << rival.name << " -> Hands: " << rival.totals.hands << ", Net chips: " << rival.totals.net
+                     << ", Showdowns won: " << rival.totals.showdownWins << "/" << rival.totals.showdowns << "\n";
             }
-            cout << endl;
         }
+        if (!flowPlayer.empty()) {
+            InteractionTotals totals = store.between(flowPlayer, flowRival, lastHands);
+            cout << flowPlayer << " against " << flowRival << window << ": " << totals.hands << " hands, "
+                 << totals.rounds << " betting rounds, " << totals.chips << " chips bet, net chip flow " << totals.net
+                 << ", showdowns won " << totals.showdownWins << "/" << totals.showdowns << "\n";
+        }
+        double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        if (!rivalsOf.empty() || !flowPlayer.empty()) cout << "Answered in " << seconds * 1000 << " ms" << endl;
     }
-
-    // Function to evaluate the player's hand 
-    //
-    // Increments the number of hands played by the player and returns a score for the hand.
-    //
-    // Returns:
-    // - int: A score representing the strength of the player's hand.
-
-    int evaluateHand() {
-        handsPlayed++;
-        return rand() % 10;  // Random score for simplicity
+    catch (const exception& e) {
+        cout << e.what() << endl;
+        return 1;
     }
+    return 0;
+}
 
-    // Function to evaluate hand strength based on community cards
-    //
-    // Evaluates the strength of the player's hand in combination with community cards, considering pairs, three of a kind, etc.
-    //
-    // Parameters:
-    // - Card communityCards[]: Array of community cards dealt on the table.
-    // - int communitySize: The number of community cards available.
-    //
-    // Returns:
-    // - int: A score representing the strength of the hand based on the cards available.
-
-    int evaluateHandStrength(Card communityCards[], int communitySize) {
-        int score = 0;
-
-        // Count pairs, three of a kind, etc.
-        map<string, int> rankCount;
-        for (int i = 0; i < communitySize; ++i) {
-            rankCount[communityCards[i].rank]++;
-        }
-        for (int i = 0; i < 2; ++i) {
-            rankCount[hand[i].rank]++;
+// Function to summarise a hand history file from the command line
+//
+// Usage: --read-history <file> [--show <n>]
+// Streams through every hand in the file and reports totals and wins per player; --show also
+// prints the first n hands in full.
+//
+// Parameters:
+// - int argc, char* argv[]: The command line arguments, starting with --read-history.
+//
+// Returns:
+// - int: The process exit code.
+int runHistoryTool(int argc, char* argv[]) {
+    long long handsToShow = 0;
+    if (argc < 3) {
+        cout << "Usage: --read-history <file> [--show <n>]" << endl;
+        return 1;
+    }
+
+    try {
+        for (int i = 3; i < argc; ++i) {
+            string arg = argv[i];
+            if (arg == "--show" && i + 1 < argc) {
+                handsToShow = stoll(argv[++i]);
+            }
+            else {
+                throw invalid_argument("Unexpected argument: " + arg);
+            }
         }
 
-        // Calculate score based on pairs
-        for (const auto& entry : rankCount) {
-            if (entry.second == 2) {
-                score += 2;  // Pair
+        auto start = chrono::steady_clock::now();
+        HandHistoryReader reader(argv[2]);
+        HandHistoryReader::Hand hand;
+        long long hands = 0;
+        long long actions = 0;
+        long long chips = 0;
+        uint32_t tables = 0;
+        map<string, long long> wins;
+
+        while (reader.next(hand)) {
+            const HandRecord& record = *hand.record;
+            hands++;
+            actions += record.numActions;
+            chips += record.pot;
+            tables = max(tables, record.table + 1);
+            if (record.winner >= 0) {
+                wins[record.names[record.winner]]++;
             }
-            else if (entry.second == 3) {
-                score += 6;  // Three of a kind
+
+            if (hands > handsToShow) continue;
+            cout << "Table " << record.table << ", hand " << record.handNumber << " (seed " << record.seed << ")\n";
+            for (int i = 0; i < record.numSeats; ++i) {
+                cout << "  " << record.names[i] << ": " << record.holeCards[i][0].shortName() << record.holeCards[i][1].shortName() << "\n";
+            }
+            cout << "  Board:";
+            for (int i = 0; i < record.boardSize; ++i) {
+                cout << " " << record.board[i].shortName();
             }
-            else if (entry.second == 4) {
-                score += 10; // Four of a kind
+            cout << "\n";
+            for (int i = 0; i < record.numActions; ++i) {
+                const ActionRecord& action = hand.actions[i];
+                cout << "  " << ActionLog::describe(action, action.seat < record.numSeats ? record.names[action.seat] : "?") << "\n";
             }
+            cout << "  Pot " << record.pot << ", won by " << (record.winner >= 0 ? record.names[record.winner] : "nobody") << "\n\n";
         }
+        double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
 
-        return score;
-    }
-
-    // Function to save player's state to a file
-    //
-    // Saves the current state of the player, including name, chips, games won, hands played, and hands won.
-    //
-    // Parameters:
-    // - ofstream& file: The output file stream to write the player's state.
-    void savePlayerState(ofstream& file) {
-        file << name << " " << chips << " " << gamesWon << " " << handsPlayed << " " << handsWon << endl;
-    }
-
-    // Function to load player's state from a file
-    //
-    // Loads the player's state from a file, updating name, chips, games won, hands played, and hands won.
-    //
-    // Parameters:
-    // - ifstream& file: The input file stream to read the player's state.
-    void loadPlayerState(ifstream& file) {
-        file >> name >> chips >> gamesWon >> handsPlayed >> handsWon;
+        cout << hands << " hands from " << tables << " tables, " << actions << " actions, average pot "
+             << (hands > 0 ? chips / hands : 0) << " chips (read in " << seconds << " s)\n";
+        for (const auto& entry : wins) {
+            cout << entry.first << " -> Hands Won: " << entry.second << endl;
+        }
     }
-
-    // Function to display player statistics
-    //
-    // Outputs detailed information about the player's performance, including chips, games won, hands played, and hands won.
-
-    void displayPlayerStatistics() {
-        cout << "Player Statistics for " << name << ":\n";
-        cout << "Chips: " << chips << endl;
-        cout << "Games Won: " << gamesWon << endl;
-        cout << "Hands Played: " << handsPlayed << endl;
-        cout << "Hands Won: " << handsWon << endl;
+    catch (const exception& e) {
+        cout << e.what() << endl;
+        return 1;
     }
-};
-
-// Function to introduce a delay (for dramatic effect)
-//
-// Pauses the program for a specified number of seconds
-//
-// Parameters:
-// - int seconds: The number of seconds to delay.
-void delay(int seconds) {
-    this_thread::sleep_for(chrono::seconds(seconds));
-}
-
-// Function to display the current pot
-//
-// Outputs the total number of chips in the pot for the current round.
-//
-// Parameters:
-// - int pot: The current value of the pot.
-
-void displayPot(int pot) {
-    cout << "The current pot is: " << pot << " chips." << endl;
+    return 0;
 }
 
-// Function to determine the winner during showdown
+// Function to train the bots' strategy from the command line
 //
-// Evaluates each player's hand and determines the winner based on their hand strength.
-// If all players fold, no winner is declared.
+// Usage: --train [--iterations <n>] [--threads <n>] [--seed <n>] [--out <file>] [--checkpoint <file>] [--resume <file>]
+// Runs the CFR trainer (see CfrTrainer) in rounds of a tenth of the iterations, printing progress and,
+// with --checkpoint, saving the training state after every round. --resume carries on from a
+// checkpoint. The average strategy is written to --out (bot_strategy.bin by default) for the
+// bots to load with --strategy.
 //
 // Parameters:
-// - Player players[]: Array of players participating in the game.
-// - int numPlayers: The number of players in the game.
-// - Card communityCards[]: Array of community cards dealt on the table.
-// - int communitySize: The number of community cards available.
-
-void showdown(Player players[], int numPlayers, Card communityCards[], int communitySize, int& pot) {
-    cout << "\nShowdown! Evaluating hands..." << endl;
-    delay(2);
+// - int argc, char* argv[]: The command line arguments, starting with --train.
+//
+// Returns:
+// - int: The process exit code.
+int runTrainer(int argc, char* argv[]) {
+    long long iterations = 100000;
+    int numThreads = 0;
+    uint64_t seed = 1;
+    string outPath = "bot_strategy.bin";
+    string checkpointPath;
+    string resumePath;
+
+    try {
+        for (int i = 2; i < argc; ++i) {
+            string arg = argv[i];
+            bool hasValue = i + 1 < argc;
+            if (arg == "--iterations" && hasValue) {
+                iterations = stoll(argv[++i]);
+            }
+            else if (arg == "--threads" && hasValue) {
+                numThreads = stoi(argv[++i]);
+            }
+            else if (arg == "--seed" && hasValue) {
+                seed = parseSeed(argv[++i]);
+            }
+            else if (arg == "--out" && hasValue) {
+                outPath = argv[++i];
+            }
+            else if (arg == "--checkpoint" && hasValue) {
+                checkpointPath = argv[++i];
+            }
+            else if (arg == "--resume" && hasValue) {
+                resumePath = argv[++i];
+            }
+            else {
+                throw invalid_argument("Unexpected argument: " + arg);
+            }
+        }
 
-    int bestScore = -1;
-    Player* winner = nullptr;
+        unique_ptr<CfrTrainer> trainer(new CfrTrainer(seed));
+        if (!resumePath.empty()) {
+            trainer->loadCheckpoint(resumePath);
+            cout << "Resuming from " << trainer->iterations() << " iterations" << endl;
+        }
 
-    for (int i = 0; i < numPlayers; ++i) {
-        if (!players[i].folded) {
-            players[i].showHand();  // Reveal bot hands during showdown
-            int score = players[i].evaluateHandStrength(communityCards, communitySize);
-            cout << players[i].name << " has a hand score of " << score << " based on their hand and community cards." << endl;
-
-            if (score > bestScore) {
-                bestScore = score;
-                winner = &players[i];
+        const long long round = max(1LL, iterations / 10);
+        auto start = chrono::steady_clock::now();
+        for (long long trained = 0; trained < iterations; trained += round) {
+            trainer->train(min(round, iterations - trained), numThreads);
+            double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+            cout << trainer->iterations() << " iterations, " << static_cast<long long>((trained + min(round, iterations - trained)) / max(seconds, 1e-9))
+                 << " iterations/sec" << endl;
+            if (!checkpointPath.empty()) {
+                trainer->saveCheckpoint(checkpointPath);
             }
         }
-    }
 
-    if (winner) {
-        cout << winner->name << " wins the pot of " << pot << " chips!" << endl;
-        winner->chips += pot;  // Winner takes the pot
-        pot = 0; // Reset pot after awarding it to the winner
-        winner->gamesWon++;
-        winner->handsWon++;
+        trainer->averageStrategy().save(outPath);
+        cout << "Strategy written to " << outPath << endl;
     }
-    else {
-        cout << "No winner, all players folded." << endl;
+    catch (const exception& e) {
+        cout << e.what() << endl;
+        return 1;
     }
+    return 0;
 }
 
-// Function to display betting history for the round
+// Function to build the preflop equity table from the command line
 //
-// Outputs a list of all the actions taken by players during the current betting round.
+// Usage: --build-preflop [--out <file>] [--trials <n>] [--threads <n>] [--seed <n>]
+// Computes the equity of the 169 starting hand classes against 1 to 5 random hands (see
+// PreflopTable) and writes the table, to preflop_equity.bin by default, where the console
+// picks it up at startup. Prints the best and worst classes heads-up as a check.
 //
 // Parameters:
-// - list<string> actionHistory: List containing the history of actions taken during the round.
-
-void displayBettingHistory(list<string> actionHistory) {
-    cout << "Betting History for this round:\n";
-    for (const string& action : actionHistory) {
-        cout << action << endl;
-    }
-}
+// - int argc, char* argv[]: The command line arguments, starting with --build-preflop.
+//
+// Returns:
+// - int: The process exit code.
+int runPreflopBuilder(int argc, char* argv[]) {
+    string outPath = PREFLOP_TABLE_PATH;
+    long long trials = PreflopTable::DEFAULT_TRIALS;
+    int numThreads = 0;
+    uint64_t seed = 1;
+
+    try {
+        for (int i = 2; i < argc; ++i) {
+            string arg = argv[i];
+            bool hasValue = i + 1 < argc;
+            if (arg == "--out" && hasValue) {
+                outPath = argv[++i];
+            }
+            else if (arg == "--trials" && hasValue) {
+                trials = stoll(argv[++i]);
+            }
+            else if (arg == "--threads" && hasValue) {
+                numThreads = stoi(argv[++i]);
+            }
+            else if (arg == "--seed" && hasValue) {
+                seed = parseSeed(argv[++i]);
+            }
+            else {
+                throw invalid_argument("Unexpected argument: " + arg);
+            }
+        }
 
-// Function to save the game state to a file
-//
-// Saves the state of all players participating in the game to a file.
-//
-// Parameters:
-// - Player players[]: Array of players participating in the game.
-// - int numPlayers: The number of players in the game.
+        auto start = chrono::steady_clock::now();
+        PreflopTable::build(outPath, trials, seed, numThreads);
+        double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
 
-void saveGameState(Player players[], int numPlayers) {
-    ofstream file("poker_game_state.txt");
-    if (file.is_open()) {
-        for (int i = 0; i < numPlayers; ++i) {
-            players[i].savePlayerState(file);
+        PreflopTable preflopTable(outPath);
+        int best = 0, worst = 0;
+        for (int c = 1; c < PreflopTable::NUM_CLASSES; ++c) {
+            if (preflopTable.equity(c, 1) > preflopTable.equity(best, 1)) best = c;
+            if (preflopTable.equity(c, 1) < preflopTable.equity(worst, 1)) worst = c;
         }
-        file.close();
-        cout << "Game state saved successfully." << endl;
+        cout << "Preflop table written to " << outPath << " in " << seconds << " s (" << trials << " runouts per entry)\n";
+        cout << "Best heads-up: " << PreflopTable::className(best) << " " << preflopTable.equity(best, 1) * 100 << "%, worst: "
+             << PreflopTable::className(worst) << " " << preflopTable.equity(worst, 1) * 100 << "%" << endl;
     }
-    else {
-        cout << "Unable to save game state." << endl;
+    catch (const exception& e) {
+        cout << e.what() << endl;
+        return 1;
     }
+    return 0;
 }
 
-// Function to load the game from a file
+// Function to introduce a delay (for dramatic effect)
 //
-// Loads the state of all players from a saved file and updates the game 
+// Pauses the program for a specified number of seconds; the game calls it through GameOptions::pause.
 //
 // Parameters:
-// - Player players[]: Array to store the players loaded from the file.
-// - int& numPlayers: The number of players loaded from the file.
-
-void loadGameState(Player players[], int& numPlayers) {
-    ifstream file("poker_game_state.txt");
-    if (file.is_open()) {
-        numPlayers = 0;
-        while (numPlayers < MAX_PLAYERS && file >> players[numPlayers].name >> players[numPlayers].chips >> players[numPlayers].gamesWon >> players[numPlayers].handsPlayed >> players[numPlayers].handsWon) {
-            numPlayers++;
-        }
-        file.close();
-        cout << "Game state loaded successfully." << endl;
-    }
-    else {
-        cout << "Unable to load game state." << endl;
-    }
+// - int seconds: The number of seconds to delay.
+void delay(int seconds) {
+    this_thread::sleep_for(chrono::seconds(seconds));
 }
 
-
-// Function to store and print player statistics in a hash table
-//
-// This function uses an unordered_map to store each player's name as the key
-// and a pair containing their games won and chip count as the value.
-//
-// Parameters:
-// - Player players[]: Array of players participating in the game.
-// - int numPlayers: The total number of players in the game.
+// Function to display an introduction screen
 //
-// Methods:
-// - playerStats(Player players[], int numPlayers):
-//     Loops through each player and stores their statistics in the hash table.
-//     Displays the statistics
-void playerStats(Player players[], int numPlayers) {
-    unordered_map<string, pair<int, int>> stats; // Player name -> (Games Won, Chips)
-
-    // Populate the hash table with player statistics
-    for (int i = 0; i < numPlayers; ++i) {
-        stats[players[i].name] = {players[i].gamesWon, players[i].chips};
-    }
+// Provides an introduction to the game, explaining the rules and gameplay objectives to the user.
 
-    // Display player statistics
-    cout << "\nPlayer Statistics:\n";
-    for (const auto& stat : stats) {
-        cout << stat.first << " -> Games Won: " << stat.second.first << ", Chips: " << stat.second.second << endl;
-    }
+void WelcomeScreen() {
+    cout << "---------------------------------------------------\n";
+    cout << "           Welcome to Texas Hold'em Poker!\n";
+    cout << "---------------------------------------------------\n";
+    cout << "In this game, you will be playing against AI\n";
+    cout << "Players in a classic poker setting. Use your \n";
+    cout << "skill and a bit of luck to win chips and \n";
+    cout << "become the ultimate poker champion!!!!WOOHOO\n\n";
+    cout << "---------------------------------------------------\n";
+    cout << "\nBasic Rules:\n";
+    cout << "1. Each player is dealt two cards, known as hole cards.\n";
+    cout << "2. There are five community cards dealt in three stages: \n";
+    cout << "   the Flop (3 cards), the Turn (1 card), and the River (1 card).\n";
+    cout << "3. Players use their hole cards and the community cards \n";
+    cout << "   to make the best possible five-card hand.\n";
+    cout << "4. Betting occurs before the Flop, after the Flop, \n";
+    cout << "   after the Turn, and after the River.\n";
+    cout << "5. You can bet, call, raise, check, fold, or even quit the game.\n";
+    cout << "6. The goal is to win chips by having the best hand \n";
+    cout << "   or convincing other players to fold.\n";
+    cout << "---------------------------------------------------\n";
+    cout << "Let's get started!\n";
+    cout << "---------------------------------------------------\n\n";
+    delay(3);
 }
 
-
-// Function to manage side pots in case multiple players go all-in
+// Function to ask a human player at the console for their action
 //
-// Handles the calculation and distribution of side pots if multiple players go all-in with different amounts.
+// Lists the actions the table allows and reads one, with the amount to bet or raise to. The table
+// rejects anything else it cannot accept and gameLoop asks again. If input runs out the player folds.
 //
 // Parameters:
-// - map<Player*, int>& sidePots: Map storing each player and their corresponding side pot value.
-// - Player players[]: Array of players participating in the game.
-// - int numPlayers: The number of players in the game.
-void manageSidePot(map<Player*, int>& sidePots, Player players[], int numPlayers) {
-    for (int i = 0; i < numPlayers; ++i) {
-        if (players[i].chips == 0 && !players[i].folded) {
-            sidePots[&players[i]] = players[i].chips;
+// - const Table& table: The table, whose seat to act is the human player.
+//
+// Returns:
+// - Action: The action entered.
+Action consoleAction(const Table& table) {
+    static const char* actionNames[] = { "Bet", "Raise", "Call", "Check", "Fold" };
+    const Decision& decision = table.decision();
+    const Player& player = table.player(decision.seat);
+
+    for (;;) {
+        cout << player.name << ", it's your turn. You have " << player.chips << " chips";
+        if (decision.toCall > 0) cout << " and " << decision.toCall << " to call";
+        cout << ". Enter your action (";
+        bool first = true;
+        for (int i = 0; i < 5; ++i) {
+            if (!decision.canTake(static_cast<ActionType>(i))) continue;
+            cout << (first ? "" : ", ") << actionNames[i];
+            first = false;
+        }
+        cout << "): ";
+
+        string word;
+        if (!(cin >> word)) return { ActionType::Fold, 0 };
+        for (int i = 0; i < 5; ++i) {
+            if (word != actionNames[i]) continue;
+            ActionType type = static_cast<ActionType>(i);
+            if (type != ActionType::Bet && type != ActionType::Raise) return { type, 0 };
+
+            int amount;
+            cout << "Enter the total to " << (decision.currentBet == 0 ? "bet" : "raise to") << " (at least "
+                 << min(decision.minRaise, decision.maxRaise) << ", all-in " << decision.maxRaise << "): ";
+            while (!(cin >> amount) || amount <= 0) {
+                if (cin.eof()) return { ActionType::Fold, 0 };
+                cout << "Invalid input. Please enter a valid positive bet amount: ";
+                cin.clear();
+                cin.ignore(numeric_limits<streamsize>::max(), '\n');
+            }
+            if (amount > decision.maxRaise) {
+                cout << "You don't have enough chips. Betting all your chips instead." << endl;
+            }
+            return { type, amount };
         }
-    }
-
-    // side pot distribution 
-    for (auto& pot : sidePots) {
-        cout << "Side pot for " << pot.first->name << " is " << pot.second << " chips." << endl;
+        cout << "Invalid action. Please try again." << endl;
     }
 }
 
-// Merge two halves of an array of Players
+// Function to ask at the console whether to play another hand
 //
-// Combines two sorted subarrays into one sorted array based on chip counts (descending order).
-// Left subarray: arr[left...mid]
-// Right subarray: arr[mid+1...right]
-void merge(Player arr[], int left, int mid, int right) {
-    int n1 = mid - left + 1;
-    int n2 = right - mid;    
-
-    // Create temporary arrays for the two halves
-    Player* L = new Player[n1];
-    Player* R = new Player[n2];
-
-    // Copy data into the temporary arrays
-    for (int i = 0; i < n1; ++i) L[i] = arr[left + i];
-    for (int i = 0; i < n2; ++i) R[i] = arr[mid + 1 + i];
-
-    int i = 0, j = 0, k = left; 
-
-    // Merge the two arrays 
-    while (i < n1 && j < n2) {
-        if (L[i].chips >= R[j].chips) { 
-            arr[k++] = L[i++];
-        } else {
-            arr[k++] = R[j++];
-        }
-    }
-
-    // Copy any remaining elements from the left subarray
-    while (i < n1) arr[k++] = L[i++];
-
-    // Copy any remaining elements from the right subarray
-    while (j < n2) arr[k++] = R[j++];
-
-    
-    delete[] L;
-    delete[] R;
+// Returns:
+// - bool: False if the user answers no or input runs out.
+bool consoleContinue() {
+    char answer;
+    cout << "\nWould you like to continue to the next round? (y/n): ";
+    if (!(cin >> answer)) return false;
+    return answer != 'n' && answer != 'N';
 }
 
-// Perform merge sort on an array of Players
+// Function to ask at the console whether to save the game, and save it if so
 //
-// Recursively splits the array into halves, sorts them, and merges them back together.
-// Sorts players in descending order of chip counts.
-void mergeSort(Player arr[], int left, int right) {
-    if (left < right) {
-        int mid = left + (right - left) / 2; // Find the middle point
-        mergeSort(arr, left, mid);          // Sort the left half
-        mergeSort(arr, mid + 1, right);     // Sort the right half
-        merge(arr, left, mid, right);       // Merge the two halves
+// Parameters:
+// - const Player players[]: The players to save.
+// - int numPlayers: The number of players.
+// - const SessionState& session: Where the session stands.
+void consoleSave(const Player players[], int numPlayers, const SessionState& session) {
+    char answer;
+    cout << "\nWould you like to save the game? (y/n): ";
+    if (cin >> answer && (answer == 'y' || answer == 'Y')) {
+        saveGameState(players, numPlayers, session);
     }
 }
 
-
-
-// Struct for a tree node in PlayerTree
-//
-// Each node stores a player's info and has pointers to its left and right child nodes.
-// Players with more chips go to the left, and players with fewer chips go to the right.
-struct TreeNode {
-    Player player;      
-    TreeNode* left;     
-    TreeNode* right;   
-
-    // Constructor to set up the node with a player's info
-    TreeNode(Player p) : player(p), left(nullptr), right(nullptr) {}
-};
-
-// Class for a binary search tree to organize players
+// Function to run the equity calculator from the command line
 //
-// Players are sorted by chip count. The tree helps display them in descending order.
-class PlayerTree {
-public:
-    TreeNode* root; // The root node of the tree
-
-    // Constructor to initialize an empty tree
-    PlayerTree() : root(nullptr) {}
-
-    // Insert a player into the tree
-    //
-    // Adds a player based on chip count. Higher chip players go left, lower chip players go right.
-    void insert(TreeNode*& node, Player player) {
-        if (!node) {
-            node = new TreeNode(player); // Create a new node if the spot is empty
-            return;
-        }
-        if (player.chips > node->player.chips) {
-            insert(node->left, player); // Go left for more chips
-        } else {
-            insert(node->right, player); // Go right for fewer chips
-        }
-    }
-
-    // In-order traversal to display players
-    //
-    // Visits all nodes and prints players in descending order of chips.
-    void inOrder(TreeNode* node) {
-        if (!node) return; // Stop if the node is null
-        inOrder(node->left); // Check the left subtree
-        cout << node->player.name << " -> Chips: " << node->player.chips << endl; // Print player info
-        inOrder(node->right); // Check the right subtree
-    }
-
-    // Add a player to the tree
-    //
-    // Uses insert() to add a new player.
-    void addPlayer(Player player) {
-        insert(root, player);
-    }
-
-    // Display all players in descending order of chips
-    void displayPlayers() {
-        inOrder(root);
-    }
-};
-
-
-// Function to record betting interactions between players
+// Usage: --equity <hand> <hand> ... [--board <cards>] [--trials <n>] [--seed <n>] [--threads <n>] [--exact]
+// Hands and board use short notation, e.g. "AhKh", and "????" stands for a random hand.
+// --exact enumerates every board instead of sampling; it needs all hands known.
 //
-// Adds an interaction between all active players in the current betting round.
 // Parameters:
-// - Player players[]: The array of players.
-// - int numPlayers: Total number of players in the game.
-// - int currentBet: The current betting amount in the round.
-// - InterGraph& interactions: The graph to record interactions.
-void betInter(Player players[], int numPlayers, int currentBet, InterGraph& interactions) {
-    for (int i = 0; i < numPlayers; ++i) {
-        if (!players[i].folded) { // Only include players still in the game
-            for (int j = i + 1; j < numPlayers; ++j) {
-                if (!players[j].folded) {
-                    // Add interaction between players[i] and players[j]
-                    interactions.addInter(players[i].name, players[j].name, currentBet);
-                }
+// - int argc, char* argv[]: The command line arguments, starting with --equity.
+//
+// Returns:
+// - int: The process exit code.
+int runEquityTool(int argc, char* argv[]) {
+    Card holeCards[MAX_PLAYERS][2];
+    Card board[5];
+    int numPlayers = 0;
+    int boardSize = 0;
+    long long trials = 1000000;
+    uint64_t seed = static_cast<uint64_t>(time(0));
+    int numThreads = 0;
+    bool exact = false;
+
+    try {
+        for (int i = 2; i < argc; ++i) {
+            string arg = argv[i];
+            bool hasValue = i + 1 < argc;
+            if (arg == "--board" && hasValue) {
+                boardSize = parseCards(argv[++i], board, 5);
+            }
+            else if (arg == "--trials" && hasValue) {
+                trials = stoll(argv[++i]);
+            }
+            else if (arg == "--seed" && hasValue) {
+                seed = parseSeed(argv[++i]);
+            }
+            else if (arg == "--threads" && hasValue) {
+                numThreads = stoi(argv[++i]);
+            }
+            else if (arg == "--exact") {
+                exact = true;
+            }
+            else if (numPlayers < MAX_PLAYERS && parseCards(arg, holeCards[numPlayers], 2) == 2) {
+                numPlayers++;
+            }
+            else {
+                throw invalid_argument("Unexpected argument: " + arg);
             }
         }
-    }
-}
 
+        HandEvaluator::instance(); // Build the lookup tables before timing
+        auto start = chrono::steady_clock::now();
+        EquityResult result = exact
+            ? EquityCalculator::enumerate(holeCards, numPlayers, board, boardSize, numThreads)
+            : EquityCalculator::monteCarlo(holeCards, numPlayers, board, boardSize, trials, seed, numThreads);
+        double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
 
-// Recursive function to display community cards
-//
-// Parameters:
-// - Card communityCards[]: Array of community cards.
-// - int index: The current index being processed.
-// - int totalCards: Total number of community cards dealt.
-void recursiveComcard(Card communityCards[], int index, int totalCards) {
-    if (index >= totalCards) return; // Base case: No more cards to display
-
-    // Display the current card
-    cout << communityCards[index].rank << " of " << communityCards[index].suit;
-
-  
-    if (index < totalCards - 1) cout << ", ";
-
-    // Recursive call for the next card
-    recursiveComcard(communityCards, index + 1, totalCards);
+        cout << "Board: " << (boardSize == 0 ? "(none)" : "");
+        for (int i = 0; i < boardSize; ++i) cout << board[i].shortName();
+        cout << "\n" << result.trials << " runouts in " << seconds << " s ("
+             << static_cast<long long>(result.trials / max(seconds, 1e-9)) << " runouts/sec"
+             << (exact ? ", exact" : "") << ")\n";
+        for (int p = 0; p < numPlayers; ++p) {
+            cout << holeCards[p][0].shortName() << holeCards[p][1].shortName()
+                 << "  win " << result.win[p] * 100 << "%  tie " << result.tie[p] * 100
+                 << "%  equity " << result.equity[p] * 100 << "%" << endl;
+        }
+    }
+    catch (const exception& e) {
+        cout << e.what() << endl;
+        return 1;
+    }
+    return 0;
 }
 
-
-// Main game loop
+// Function to compute the equity of one range against another from the command line
 //
-// Handles the entire gameplay process, including shuffling the deck, dealing cards, managing betting rounds, and determining the winner.
+// Usage: --range-equity <range> <range> [--board <cards>] [--boards <n>] [--seed <n>]
+// Ranges use the usual notation, e.g. "AKs, TT+, A5s-A2s" (see Range). Boards with more
+// completions than --boards are sampled.
 //
 // Parameters:
-// - Player players[]: Array of players participating in the game.
-// - int numPlayers: The number of players in the game.
-// - Deck& deck: The deck of cards used in the game.
-void gameLoop(Player players[], int numPlayers, Deck& deck, InterGraph& interactions) {
-    int pot = 0;
-    int currentBet = 0;
-    list<string> actionHistory;
-    Card communityCards[5];
-    int communityIndex = 0;
-    set<string> eliminatedPlayers; // Set to store eliminated players
-    queue<int> turnOrder;          // Queue to manage turn order of players
-
-    // Initialize turn order
-    for (int i = 0; i < numPlayers; ++i) {
-        turnOrder.push(i);
-    }
-
-    // Main game loop runs until only one player has chips remaining
-    while (count_if(players, players + numPlayers, [](Player& p) { return p.chips > 0; }) > 1) {
-        cout << "\nNew Round Begins!" << endl;
-        deck.shuffle();
-
-        // Reset community cards
-        communityIndex = 0;
-
-        // Deal two cards to each player
-        for (int i = 0; i < numPlayers; ++i) {
-            players[i].folded = false;
-            players[i].receiveCard(deck.dealCard(), 0);
-            players[i].receiveCard(deck.dealCard(), 1);
-        }
-
-        // Show each player's hand (hiding bot cards initially)
-        for (int i = 0; i < numPlayers; ++i) {
-            if (players[i].name.find("Bot") != string::npos) {
-                players[i].showHand(true); // Hide bot cards
-            } else {
-                players[i].showHand();    // Show human player's cards
+// - int argc, char* argv[]: The command line arguments, starting with --range-equity.
+//
+// Returns:
+// - int: The process exit code.
+int runRangeEquityTool(int argc, char* argv[]) {
+    Range ranges[2];
+    int numRanges = 0;
+    Card board[5];
+    int boardSize = 0;
+    long long maxBoards = 2000;
+    uint64_t seed = static_cast<uint64_t>(time(0));
+
+    try {
+        for (int i = 2; i < argc; ++i) {
+            string arg = argv[i];
+            bool hasValue = i + 1 < argc;
+            if (arg == "--board" && hasValue) {
+                boardSize = parseCards(argv[++i], board, 5);
             }
-        }
-
-        // First Betting Round
-        cout << "\nBetting Round Begins" << endl;
-        for (int i = 0; i < numPlayers; ++i) {
-            if (!turnOrder.empty()) {
-                int currentPlayerIndex = turnOrder.front();
-                turnOrder.pop();
-                if (!players[currentPlayerIndex].folded && players[currentPlayerIndex].chips > 0) {
-                    players[currentPlayerIndex].takeAction(currentBet, pot, actionHistory, communityCards, communityIndex);
-                    turnOrder.push(currentPlayerIndex);
-                }
+            else if (arg == "--boards" && hasValue) {
+                maxBoards = stoll(argv[++i]);
             }
-        }
-
-        // Log interactions after the first betting round
-        betInter(players, numPlayers, currentBet, interactions);
-
-        displayPot(pot);
-
-        // Dealing the Flop
-        cout << "\nDealing the Flop..." << endl;
-        for (int i = 0; i < 3; ++i) {
-            if (communityIndex < 5) {
-                communityCards[communityIndex++] = deck.dealCard();
+            else if (arg == "--seed" && hasValue) {
+                seed = parseSeed(argv[++i]);
             }
-        }
-        delay(1);
-
-        // Show community cards using recursion
-        cout << "Community cards: ";
-        recursiveComcard(communityCards, 0, communityIndex);
-        cout << endl;
-
-        // Second Betting Round
-        cout << "\nBetting Round 2 Begins" << endl;
-        for (int i = 0; i < numPlayers; ++i) {
-            if (!turnOrder.empty()) {
-                int currentPlayerIndex = turnOrder.front();
-                turnOrder.pop();
-                if (!players[currentPlayerIndex].folded && players[currentPlayerIndex].chips > 0) {
-                    players[currentPlayerIndex].takeAction(currentBet, pot, actionHistory, communityCards, communityIndex);
-                    turnOrder.push(currentPlayerIndex);
-                }
+            else if (numRanges < 2) {
+                ranges[numRanges++] = Range::parse(arg);
+            }
+            else {
+                throw invalid_argument("Unexpected argument: " + arg);
             }
         }
-
-        // Log interactions after the second betting round
-        betInter(players, numPlayers, currentBet, interactions);
-
-        displayPot(pot);
-
-        // Dealing the Turn
-        cout << "\nDealing the Turn..." << endl;
-        if (communityIndex < 5) {
-            communityCards[communityIndex++] = deck.dealCard();
+        if (numRanges < 2) {
+            throw invalid_argument("Two ranges are needed.");
         }
-        delay(1);
 
-        // Show updated community cards using recursion
-        cout << "Community cards: ";
-        recursiveComcard(communityCards, 0, communityIndex);
-        cout << endl;
+        HandEvaluator::instance(); // Build the lookup tables before timing
+        auto start = chrono::steady_clock::now();
+        RangeEquityResult result = rangeEquity(ranges[0], ranges[1], board, boardSize, maxBoards, seed);
+        double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
 
-        // Third Betting Round
-        cout << "\nBetting Round 3 Begins" << endl;
-        for (int i = 0; i < numPlayers; ++i) {
-            if (!turnOrder.empty()) {
-                int currentPlayerIndex = turnOrder.front();
-                turnOrder.pop();
-                if (!players[currentPlayerIndex].folded && players[currentPlayerIndex].chips > 0) {
-                    players[currentPlayerIndex].takeAction(currentBet, pot, actionHistory, communityCards, communityIndex);
-                    turnOrder.push(currentPlayerIndex);
-                }
-            }
-        }
+        cout << "Board: " << (boardSize == 0 ? "(none)" : "");
+        for (int i = 0; i < boardSize; ++i) cout << board[i].shortName();
+        cout << "\n" << ranges[0].size() << " against " << ranges[1].size() << " combinations, " << result.boards
+             << " boards in " << seconds * 1000 << " ms\n";
+        cout << "First range  win " << result.win * 100 << "%  tie " << result.tie * 100 << "%  equity "
+             << result.equity * 100 << "%" << endl;
+    }
+    catch (const exception& e) {
+        cout << e.what() << endl;
+        return 1;
+    }
+    return 0;
+}
 
-        // Log interactions after the third betting round
-        betInter(players, numPlayers, currentBet, interactions);
+// Main function to start the game
+//
+// Sets up the game environment, including initializing the deck, setting up players, and running the game loop.
+// Passing --equity runs the equity calculator, --range-equity the range against range calculator,
+// --simulate a headless bot table, --read-history the hand history reader, --query-interactions the
+// interaction store queries, --train the bot trainer and --build-preflop the preflop equity table
+// builder instead. A preflop table in the working directory is loaded at startup, and every mode shares
+// one equity cache between its bots.
+// Passing --seed <n> replays a session, --history <file> records it, --interactions <dir> adds who
+// played whom to an interaction store and --strategy <file> has the bots play a trained strategy.
+
+int main(int argc, char* argv[]) {
+    srand(static_cast<unsigned int>(time(0))); // Random number seed for shuffling, betting, etc.
 
-        displayPot(pot);
+    if (argc > 1 && string(argv[1]) == "--equity") {
+        return runEquityTool(argc, argv);
+    }
+    if (argc > 1 && string(argv[1]) == "--range-equity") {
+        return runRangeEquityTool(argc, argv);
+    }
+    if (argc > 1 && string(argv[1]) == "--build-preflop") {
+        return runPreflopBuilder(argc, argv);
+    }
 
-        // Dealing the River
-        cout << "\nDealing the River..." << endl;
-        if (communityIndex < 5) {
-            communityCards[communityIndex++] = deck.dealCard();
+    // Bots look preflop equities up in the table built by --build-preflop, when there is one
+    unique_ptr<PreflopTable> preflopTable;
+    if (ifstream(PREFLOP_TABLE_PATH)) {
+        try {
+            preflopTable.reset(new PreflopTable(PREFLOP_TABLE_PATH));
+            PreflopTable::install(preflopTable.get());
         }
-        delay(1);
-
-        // Show final community cards using recursion
-        cout << "Community cards: ";
-        recursiveComcard(communityCards, 0, communityIndex);
-        cout << endl;
-
-        // Final Betting Round
-        cout << "\nFinal Betting Round Begins" << endl;
-        for (int i = 0; i < numPlayers; ++i) {
-            if (!turnOrder.empty()) {
-                int currentPlayerIndex = turnOrder.front();
-                turnOrder.pop();
-                if (!players[currentPlayerIndex].folded && players[currentPlayerIndex].chips > 0) {
-                    players[currentPlayerIndex].takeAction(currentBet, pot, actionHistory, communityCards, communityIndex);
-                    turnOrder.push(currentPlayerIndex);
-                }
-            }
+        catch (const exception& e) {
+            cout << e.what() << " Bots will simulate preflop equities instead." << endl;
         }
+    }
 
-        // Log interactions after the final betting round
-        betInter(players, numPlayers, currentBet, interactions);
-
-        displayPot(pot);
+    // Bot equities after the flop are shared by every table through one cache
+    EquityCache equityCache;
+    EquityCache::install(&equityCache);
 
-        // Determine the winner and manage the pot
-        showdown(players, numPlayers, communityCards, communityIndex, pot);
+    if (argc > 1 && string(argv[1]) == "--simulate") {
+        return runSimulation(argc, argv);
+    }
+    if (argc > 1 && string(argv[1]) == "--read-history") {
+        return runHistoryTool(argc, argv);
+    }
+    if (argc > 1 && string(argv[1]) == "--query-interactions") {
+        return runInteractionTool(argc, argv);
+    }
+    if (argc > 1 && string(argv[1]) == "--train") {
+        return runTrainer(argc, argv);
+    }
 
-        // Eliminate players who have run out of chips
-        int remainingPlayers = 0;
-        for (int i = 0; i < numPlayers; ++i) {
-            if (players[i].chips == 0) {
-                eliminatedPlayers.insert(players[i].name);
-                players[i].folded = true;
-                cout << players[i].name << " is eliminated from the game." << endl;
-            } else {
-                players[remainingPlayers++] = players[i];
+    // --seed replays the cards and bot decisions of an earlier session, --history records the hands,
+    // --interactions keeps who played whom and --strategy loads a trained bot strategy
+    GameOptions options;
+    options.humanAction = consoleAction;
+    options.pause = delay;
+    options.continuePlaying = consoleContinue;
+    options.onSave = consoleSave;
+    unique_ptr<HandHistoryWriter> history;
+    unique_ptr<InteractionStore> interactionStore;
+    Strategy strategy;
+    try {
+        for (int i = 1; i + 1 < argc; i += 2) {
+            string arg = argv[i];
+            if (arg == "--seed") {
+                options.seed = parseSeed(argv[i + 1]);
+            }
+            else if (arg == "--history") {
+                history.reset(new HandHistoryWriter(argv[i + 1]));
+                options.history = history.get();
+            }
+            else if (arg == "--strategy") {
+                strategy.load(argv[i + 1]);
+                options.strategy = &strategy;
+            }
+            else if (arg == "--interactions") {
+                interactionStore.reset(new InteractionStore(argv[i + 1]));
             }
-        }
-        numPlayers = remainingPlayers;
-
-        // Sort players by their chip count
-        mergeSort(players, 0, numPlayers - 1);
-
-        // Allow the user to quit between rounds
-        char continueGame;
-        cout << "\nWould you like to continue to the next round? (y/n): ";
-        cin >> continueGame;
-        if (continueGame == 'n' || continueGame == 'N') {
-            cout << "Exiting the game..." << endl;
-            return;
-        }
-
-        // Allow the user to save the game
-        char saveGame;
-        cout << "\nWould you like to save the game? (y/n): ";
-        cin >> saveGame;
-        if (saveGame == 'y' || saveGame == 'Y') {
-            saveGameState(players, numPlayers);
         }
     }
-
-    // Announce the game winner
-    cout << "\nGame Over!" << endl;
-    for (int i = 0; i < numPlayers; ++i) {
-        if (players[i].chips > 0) {
-            cout << players[i].name << " is the winner with " << players[i].chips << " chips." << endl;
-        }
+    catch (const exception& e) {
+        cout << e.what() << endl;
+        return 1;
     }
-}
-
-// Function to display an introduction screen
-//
-// Provides an introduction to the game, explaining the rules and gameplay objectives to the user.
-
-void WelcomeScreen() {
-    cout << "---------------------------------------------------\n";
-    cout << "           Welcome to Texas Hold'em Poker!\n";
-    cout << "---------------------------------------------------\n";
-    cout << "In this game, you will be playing against AI\n";
-    cout << "Players in a classic poker setting. Use your \n";
-    cout << "skill and a bit of luck to win chips and \n";
-    cout << "become the ultimate poker champion!!!!WOOHOO\n\n";
-    cout << "---------------------------------------------------\n";
-    cout << "\nBasic Rules:\n";
-    cout << "1. Each player is dealt two cards, known as hole cards.\n";
-    cout << "2. There are five community cards dealt in three stages: \n";
-    cout << "   the Flop (3 cards), the Turn (1 card), and the River (1 card).\n";
-    cout << "3. Players use their hole cards and the community cards \n";
-    cout << "   to make the best possible five-card hand.\n";
-    cout << "4. Betting occurs before the Flop, after the Flop, \n";
-    cout << "   after the Turn, and after the River.\n";
-    cout << "5. You can bet, call, raise, check, fold, or even quit the game.\n";
-    cout << "6. The goal is to win chips by having the best hand \n";
-    cout << "   or convincing other players to fold.\n";
-    cout << "---------------------------------------------------\n";
-    cout << "Let's get started!\n";
-    cout << "---------------------------------------------------\n\n";
-    delay(3);
-}
 
-// Main function to start the game
-//
-// Sets up the game environment, including initializing the deck, setting up players, and running the game loop.
-
-int main() {
-    srand(static_cast<unsigned int>(time(0))); // Random number seed for shuffling, betting, etc.
-
-    
     WelcomeScreen();
 
    
@@ -1010,24 +818,21 @@ int main() {
 
    
     InterGraph interactions;     
-    PlayerTree playerRankings;   
+    Leaderboard playerRankings;
 
     char loadGame;
     cout << "Do you want to load a saved game? (y/n): ";
     cin >> loadGame;
 
-    if (loadGame == 'y' || loadGame == 'Y') {
-        
-        loadGameState(players, numPlayers);
-
-        // Add players to rankings based on saved game data
-        for (int i = 0; i < numPlayers; ++i) {
-            playerRankings.addPlayer(players[i]);
-        }
+    // A saved game carries on where it stopped, with the same players, button and cards to come
+    SessionState savedSession;
+    if ((loadGame == 'y' || loadGame == 'Y') && loadGameState(players, numPlayers, savedSession)) {
+        options.resume = &savedSession;
     } else {
         // No saved game, start new game
         cout << "Enter the number of human players (max " << MAX_PLAYERS << "): ";
         while (!(cin >> numPlayers) || numPlayers < 0 || numPlayers > MAX_PLAYERS) {
+            if (cin.eof()) return 1; // No more input, so nobody to ask
             cout << "Invalid input. Try again (1-" << MAX_PLAYERS << "): ";
             cin.clear();
             cin.ignore(numeric_limits<streamsize>::max(), '\n');
@@ -1051,33 +856,44 @@ int main() {
             players[numPlayers + i] = Player("Bot " + to_string(i + 1));
         }
         numPlayers += numBots; 
+    }
 
-        // Add all players (humans + bots) to the rankings tree
-        for (int i = 0; i < numPlayers; ++i) {
-            playerRankings.addPlayer(players[i]);
-        }
+    // Rank all players (humans + bots) by their ids; the game keeps the board up to date after every hand
+    assignPlayerIds(players, numPlayers, interactions);
+    for (int i = 0; i < numPlayers; ++i) {
+        playerRankings.update(static_cast<uint32_t>(players[i].id), players[i].chips);
     }
+    options.leaderboard = &playerRankings;
 
     // Show rankings before the game starts
     cout << "\nPlayer Rankings (before the game):\n";
-    playerRankings.displayPlayers();
+    displayRankings(playerRankings, players, numPlayers);
 
     // Run the game
-    gameLoop(players, numPlayers, deck, interactions);
-
-    // Update player rankings after the game is over
-    playerRankings = PlayerTree(); // Reset rankings
-    for (int i = 0; i < numPlayers; ++i) {
-        playerRankings.addPlayer(players[i]);
+    long long handsPlayed = gameLoop(players, numPlayers, deck, interactions, options);
+    if (interactionStore) {
+        try {
+            interactionStore->append(interactions, handsPlayed);
+        }
+        catch (const exception& e) {
+            cout << e.what() << endl;
+        }
+    }
+    if (history) {
+        try {
+            history->close();
+        }
+        catch (const exception& e) {
+            cout << e.what() << endl;
+        }
     }
 
     // Show who interacted with who during the game
-    cout << "\nPlayer Interactions:\n";
     interactions.display();
 
     // Show the updated rankings
     cout << "\nUpdated Player Rankings (after the game):\n";
-    playerRankings.displayPlayers();
+    displayRankings(playerRankings, players, numPlayers);
 
     // Show player stats like chips and hands won
     playerStats(players, numPlayers);
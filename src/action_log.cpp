@@ -0,0 +1,27 @@
+#include "poker/action_log.h"
+
+using namespace std;
+
+namespace poker {
+
+string ActionLog::describe(const ActionRecord& action, const string& playerName) {
+    switch (action.type) {
+    case ActionType::Bet:
+        return playerName + " bets " + to_string(action.amount) + " chips.";
+    case ActionType::Raise:
+        return playerName + " raises to " + to_string(action.amount) + " chips.";
+    case ActionType::Call:
+        return playerName + " calls " + to_string(action.amount) + " chips.";
+    case ActionType::Check:
+        return playerName + " checks.";
+    case ActionType::Fold:
+        return playerName + " folds.";
+    case ActionType::Bluff:
+        return playerName + " bluffs with " + to_string(action.amount) + " chips.";
+    case ActionType::Blind:
+        return playerName + " posts a blind of " + to_string(action.amount) + " chips.";
+    }
+    return playerName + " acts.";
+}
+
+} // namespace poker
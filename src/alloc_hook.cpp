@@ -0,0 +1,133 @@
+#include "poker/alloc_hook.h"
+
+#include <cstdlib>
+#include <new>
+
+using namespace std;
+
+namespace {
+
+thread_local long long allocationsOnThread = 0;
+
+void* allocate(size_t size) {
+    allocationsOnThread++;
+    return malloc(size == 0 ? 1 : size);
+}
+
+// Over-aligned types (alignas above the default, e.g. Deck) come through the align_val_t forms
+void* allocateAligned(size_t size, align_val_t alignment) {
+    allocationsOnThread++;
+    size_t bytes = static_cast<size_t>(alignment);
+#ifdef _WIN32
+    return _aligned_malloc(size == 0 ? 1 : size, bytes);
+#else
+    // aligned_alloc() needs the size to be a non-zero multiple of the alignment
+    size_t rounded = size == 0 ? bytes : (size + bytes - 1) / bytes * bytes;
+    return aligned_alloc(bytes, rounded);
+#endif
+}
+
+void releaseAligned(void* memory) {
+#ifdef _WIN32
+    _aligned_free(memory);
+#else
+    free(memory);
+#endif
+}
+
+} // namespace
+
+namespace poker {
+
+long long allocationCount() {
+    return allocationsOnThread;
+}
+
+} // namespace poker
+
+// Every form of the global operator new is replaced, so no allocation goes uncounted, and every
+// operator delete is replaced to match the allocator its new used
+
+void* operator new(size_t size) {
+    if (void* memory = allocate(size)) return memory;
+    throw bad_alloc();
+}
+
+void* operator new[](size_t size) {
+    if (void* memory = allocate(size)) return memory;
+    throw bad_alloc();
+}
+
+void* operator new(size_t size, const nothrow_t&) noexcept {
+    return allocate(size);
+}
+
+void* operator new[](size_t size, const nothrow_t&) noexcept {
+    return allocate(size);
+}
+
+void* operator new(size_t size, align_val_t alignment) {
+    if (void* memory = allocateAligned(size, alignment)) return memory;
+    throw bad_alloc();
+}
+
+void* operator new[](size_t size, align_val_t alignment) {
+    if (void* memory = allocateAligned(size, alignment)) return memory;
+    throw bad_alloc();
+}
+
+void* operator new(size_t size, align_val_t alignment, const nothrow_t&) noexcept {
+    return allocateAligned(size, alignment);
+}
+
+void* operator new[](size_t size, align_val_t alignment, const nothrow_t&) noexcept {
+    return allocateAligned(size, alignment);
+}
+
+void operator delete(void* memory) noexcept {
+    free(memory);
+}
+
+void operator delete[](void* memory) noexcept {
+    free(memory);
+}
+
+void operator delete(void* memory, size_t) noexcept {
+    free(memory);
+}
+
+void operator delete[](void* memory, size_t) noexcept {
+    free(memory);
+}
+
+void operator delete(void* memory, const nothrow_t&) noexcept {
+    free(memory);
+}
+
+void operator delete[](void* memory, const nothrow_t&) noexcept {
+    free(memory);
+}
+
+void operator delete(void* memory, align_val_t) noexcept {
+    releaseAligned(memory);
+}
+
+void operator delete[](void* memory, align_val_t) noexcept {
+    releaseAligned(memory);
+}
+
+void operator delete(void* memory, size_t, align_val_t) noexcept {
+    releaseAligned(memory);
+}
+
+void operator delete[](void* memory, size_t, align_val_t) noexcept {
+    releaseAligned(memory);
+}
+
+void operator delete(void* memory, align_val_t, const nothrow_t&) noexcept {
+    releaseAligned(memory);
+}
+
+void operator delete[](void* memory, align_val_t, const nothrow_t&) noexcept {
+    releaseAligned(memory);
+}
@@ -0,0 +1,37 @@
+#include "poker/card.h"
+
+#include <cctype>
+#include <cstring>
+#include <stdexcept>
+
+using namespace std;
+
+namespace poker {
+
+int parseCards(const string& text, Card cards[], int maxCards) {
+    int numCards = 0;
+    for (size_t i = 0; i < text.size(); ) {
+        if (isspace(static_cast<unsigned char>(text[i])) || text[i] == ',') {
+            ++i;
+            continue;
+        }
+        if (i + 1 >= text.size() || numCards >= maxCards) {
+            throw invalid_argument("Invalid cards: " + text);
+        }
+        if (text[i] == '?' && text[i + 1] == '?') {
+            cards[numCards++] = Card();
+        }
+        else {
+            const char* rank = strchr(RANK_CHARS, toupper(static_cast<unsigned char>(text[i])));
+            const char* suit = strchr(SUIT_CHARS, tolower(static_cast<unsigned char>(text[i + 1])));
+            if (rank == nullptr || suit == nullptr || *rank == '\0' || *suit == '\0') {
+                throw invalid_argument("Invalid card: " + text.substr(i, 2));
+            }
+            cards[numCards++] = Card(static_cast<int>(rank - RANK_CHARS) * 4 + static_cast<int>(suit - SUIT_CHARS));
+        }
+        i += 2;
+    }
+    return numCards;
+}
+
+} // namespace poker
@@ -0,0 +1,386 @@
+#include "poker/cfr.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+
+#include "poker/deck.h"
+#include "poker/file_io.h"
+#include "poker/hand_evaluator.h"
+#include "poker/simulation.h"
+#include "poker/table.h"
+
+using namespace std;
+
+namespace poker {
+
+namespace {
+
+// Header shared by strategy files and checkpoints
+struct StrategyHeader {
+    char magic[4];
+    uint32_t version;
+    uint32_t buckets;
+    uint32_t maxRaises;
+    uint64_t iterations;
+    uint64_t seed;
+};
+
+static_assert(sizeof(StrategyHeader) == 32, "StrategyHeader is part of the file format");
+
+const int TRAIN_CHUNK = 256; // Iterations per pool task
+
+void atomicAdd(atomic<float>& target, float value) {
+    float old = target.load(memory_order_relaxed);
+    while (!target.compare_exchange_weak(old, old + value, memory_order_relaxed)) {
+    }
+}
+
+// Function to estimate the chance of beating one random hand by the river, ties counting half
+double handStrength(const Card hole[2], const Card board[], int boardSize, Rng& rng) {
+    uint64_t dead = (1ULL << hole[0].code) | (1ULL << hole[1].code);
+    for (int i = 0; i < boardSize; ++i) {
+        dead |= 1ULL << board[i].code;
+    }
+    Card live[MAX_CARDS];
+    int numLive = 0;
+    for (int code = 0; code < MAX_CARDS; ++code) {
+        if (!(dead >> code & 1)) live[numLive++] = Card(code);
+    }
+
+    const HandEvaluator& evaluator = HandEvaluator::instance();
+    HandEvaluator::HandState mine, theirs;
+    for (int i = 0; i < boardSize; ++i) {
+        mine.add(board[i]);
+        theirs.add(board[i]);
+    }
+    mine.add(hole[0]);
+    mine.add(hole[1]);
+
+    // Each sample draws the opponent's cards and the rest of the board
+    const int needed = 2 + 5 - boardSize;
+    double score = 0;
+    for (int s = 0; s < CfrTrainer::HAND_STRENGTH_SAMPLES; ++s) {
+        for (int i = 0; i < needed; ++i) {
+            int j = i + static_cast<int>(rng.below(static_cast<uint32_t>(numLive - i)));
+            swap(live[i], live[j]);
+        }
+        HandEvaluator::HandState me = mine, opponent = theirs;
+        opponent.add(live[0]);
+        opponent.add(live[1]);
+        for (int i = 2; i < needed; ++i) {
+            me.add(live[i]);
+            opponent.add(live[i]);
+        }
+        int a = evaluator.evaluate(me);
+        int b = evaluator.evaluate(opponent);
+        score += a > b ? 1.0 : a == b ? 0.5 : 0.0;
+    }
+    return score / CfrTrainer::HAND_STRENGTH_SAMPLES;
+}
+
+void writeFile(const string& path, const StrategyHeader& header, const float* data, size_t count) {
+    // A crash while a checkpoint is written leaves the previous checkpoint, never half a file
+    writeFileAtomically(path, { { &header, sizeof(header) }, { data, sizeof(float) * count } });
+}
+
+StrategyHeader readFile(const string& path, const char magic[4], float* data, size_t count) {
+    FILE* file = fopen(path.c_str(), "rb");
+    if (!file) {
+        throw runtime_error("Cannot open " + path + ".");
+    }
+    StrategyHeader header = {};
+    bool read = fread(&header, sizeof(header), 1, file) == 1;
+    if (!read || memcmp(header.magic, magic, 4) != 0 || header.version != STRATEGY_VERSION ||
+        header.buckets != Strategy::BUCKETS || header.maxRaises != Strategy::MAX_RAISES) {
+        fclose(file);
+        throw runtime_error(path + " was not written for this version's abstraction.");
+    }
+    read = fread(data, sizeof(float), count, file) == count;
+    fclose(file);
+    if (!read) {
+        throw runtime_error(path + " is truncated.");
+    }
+    return header;
+}
+
+} // namespace
+
+Strategy::Strategy() : trained(0) {
+    for (auto& probabilities : table) {
+        fill(probabilities, probabilities + NUM_ACTIONS, 1.0f / NUM_ACTIONS);
+    }
+}
+
+void Strategy::setProbabilities(int infoSet, const float probabilities[NUM_ACTIONS]) {
+    copy(probabilities, probabilities + NUM_ACTIONS, table[infoSet]);
+}
+
+CfrAction Strategy::choose(int infoSet, bool canFold, bool canRaise, Rng& rng) const {
+    const bool legal[NUM_ACTIONS] = { canFold, true, canRaise };
+    float weights[NUM_ACTIONS];
+    float total = 0;
+    for (int a = 0; a < NUM_ACTIONS; ++a) {
+        weights[a] = legal[a] ? table[infoSet][a] : 0.0f;
+        total += weights[a];
+    }
+    if (total <= 0) return CfrAction::Call;
+
+    float draw = static_cast<float>(rng.uniform()) * total;
+    for (int a = 0; a < NUM_ACTIONS; ++a) {
+        if (draw < weights[a]) return static_cast<CfrAction>(a);
+        draw -= weights[a];
+    }
+    return canRaise ? CfrAction::Raise : CfrAction::Call;
+}
+
+void Strategy::save(const string& path) const {
+    StrategyHeader header = {};
+    memcpy(header.magic, STRATEGY_MAGIC, 4);
+    header.version = STRATEGY_VERSION;
+    header.buckets = BUCKETS;
+    header.maxRaises = MAX_RAISES;
+    header.iterations = static_cast<uint64_t>(trained);
+    writeFile(path, header, &table[0][0], NUM_INFOSETS * NUM_ACTIONS);
+}
+
+void Strategy::load(const string& path) {
+    float loaded[NUM_INFOSETS][NUM_ACTIONS];
+    StrategyHeader header = readFile(path, STRATEGY_MAGIC, &loaded[0][0], NUM_INFOSETS * NUM_ACTIONS);
+    copy(&loaded[0][0], &loaded[0][0] + NUM_INFOSETS * NUM_ACTIONS, &table[0][0]);
+    trained = static_cast<long long>(header.iterations);
+}
+
+// Struct for the cards of one training hand, reduced to what the abstraction sees
+struct CfrTrainer::Deal {
+    int buckets[2][4]; // Hand strength bucket of each player on each street
+    int result;        // Showdown result for player 0: 1 win, 0 tie, -1 loss
+};
+
+// Struct for a point in the abstract betting tree
+//
+// Player 0 has the button: it posts the small blind, acts first before the flop and last after.
+struct CfrTrainer::Node {
+    Street street;
+    int toAct;
+    int raises;          // Bets and raises on this street
+    int actions;         // Actions taken on this street
+    int contributed[2];  // Chips each player has put in over the hand
+    int streetBet[2];    // Chips each player has put in on this street
+};
+
+// Function to play an abstract action
+//
+// Returns:
+// - bool: True if the hand ended, with utility set to the traverser's winnings.
+bool CfrTrainer::applyAction(Node& node, CfrAction action, const Deal& deal, int traverser, float& utility) {
+    const int me = node.toAct;
+    const int other = 1 - me;
+    const bool facing = node.streetBet[other] > node.streetBet[me];
+    bool closes = false;
+
+    switch (action) {
+    case CfrAction::Fold:
+        utility = static_cast<float>(me == traverser ? -node.contributed[me] : node.contributed[me]);
+        return true;
+    case CfrAction::Call: {
+        int paid = node.streetBet[other] - node.streetBet[me];
+        node.streetBet[me] += paid;
+        node.contributed[me] += paid;
+        // A call ends the street except for the small blind's limp; a check ends it if someone acted before
+        closes = facing ? !(node.street == PREFLOP && node.raises == 0 && node.actions == 0) : node.actions > 0;
+        break;
+    }
+    case CfrAction::Raise: {
+        int unit = node.street >= TURN ? 2 * Table::BIG_BLIND : Table::BIG_BLIND;
+        int paid = node.streetBet[other] + unit - node.streetBet[me];
+        node.streetBet[me] += paid;
+        node.contributed[me] += paid;
+        node.raises++;
+        break;
+    }
+    }
+    node.actions++;
+    node.toAct = other;
+    if (!closes) return false;
+
+    if (node.street == RIVER) {
+        // Both players have put in the same amount, which the winner takes from the loser
+        utility = static_cast<float>(deal.result * (traverser == 0 ? 1 : -1) * node.contributed[0]);
+        return true;
+    }
+    node.street = static_cast<Street>(node.street + 1);
+    node.raises = node.actions = 0;
+    node.streetBet[0] = node.streetBet[1] = 0;
+    node.toAct = 1;
+    return false;
+}
+
+CfrTrainer::CfrTrainer(uint64_t seed) : done(0), seed(seed) {
+    for (int i = 0; i < Strategy::NUM_INFOSETS; ++i) {
+        for (int a = 0; a < Strategy::NUM_ACTIONS; ++a) {
+            regrets[i][a].store(0);
+            strategySums[i][a].store(0);
+        }
+    }
+}
+
+void CfrTrainer::train(long long iterations, int numThreads) {
+    HandEvaluator::instance(); // Build the lookup tables before the workers start
+    const long long first = done.load();
+    ThreadPool pool(numThreads);
+    for (long long start = 0; start < iterations; start += TRAIN_CHUNK) {
+        long long end = min(iterations, start + TRAIN_CHUNK);
+        pool.submit([this, first, start, end] {
+            // Iteration n always deals the same hand, however the work is split
+            for (long long i = start; i < end; ++i) {
+                iterate(Rng::splitMix(seed + static_cast<uint64_t>(first + i) * 0x9E3779B97F4A7C15ULL));
+            }
+        });
+    }
+    pool.wait();
+}
+
+void CfrTrainer::iterate(uint64_t iterationSeed) {
+    static const int boardSizes[] = { 0, 3, 4, 5 };
+    Rng rng(iterationSeed);
+    Deck deck;
+    deck.shuffle(rng, 9);
+    Card hole[2][2] = { { deck.dealCard(), deck.dealCard() }, { deck.dealCard(), deck.dealCard() } };
+    Card board[5];
+    for (Card& card : board) {
+        card = deck.dealCard();
+    }
+
+    Deal deal;
+    for (int p = 0; p < 2; ++p) {
+        for (int street = PREFLOP; street <= RIVER; ++street) {
+            deal.buckets[p][street] = Strategy::bucket(handStrength(hole[p], board, boardSizes[street], rng));
+        }
+    }
+    const HandEvaluator& evaluator = HandEvaluator::instance();
+    Card cards[7];
+    copy(board, board + 5, cards);
+    cards[5] = hole[0][0];
+    cards[6] = hole[0][1];
+    int first = evaluator.evaluate(cards, 7);
+    cards[5] = hole[1][0];
+    cards[6] = hole[1][1];
+    int second = evaluator.evaluate(cards, 7);
+    deal.result = first > second ? 1 : first == second ? 0 : -1;
+
+    Node root = { PREFLOP, 0, 0, 0, { Table::SMALL_BLIND, Table::BIG_BLIND }, { Table::SMALL_BLIND, Table::BIG_BLIND } };
+    for (int traverser = 0; traverser < 2; ++traverser) {
+        traverse(deal, root, traverser, rng);
+    }
+    done++;
+}
+
+// Function to run an external-sampling traversal of the abstract betting tree
+//
+// Returns:
+// - float: The traverser's expected winnings from this node under the current strategy.
+float CfrTrainer::traverse(const Deal& deal, const Node& node, int traverser, Rng& rng) {
+    const int player = node.toAct;
+    const bool facing = node.streetBet[1 - player] > node.streetBet[player];
+    const bool legal[Strategy::NUM_ACTIONS] = { facing, true, node.raises < Strategy::MAX_RAISES };
+    const int info = Strategy::infoSet(node.street, node.raises, facing, deal.buckets[player][node.street]);
+
+    // Regret matching: play in proportion to positive regret, uniformly if there is none
+    float strategy[Strategy::NUM_ACTIONS];
+    float positive = 0;
+    int numLegal = 0;
+    for (int a = 0; a < Strategy::NUM_ACTIONS; ++a) {
+        strategy[a] = legal[a] ? max(0.0f, regrets[info][a].load(memory_order_relaxed)) : 0.0f;
+        positive += strategy[a];
+        numLegal += legal[a];
+    }
+    for (int a = 0; a < Strategy::NUM_ACTIONS; ++a) {
+        strategy[a] = !legal[a] ? 0.0f : positive > 0 ? strategy[a] / positive : 1.0f / numLegal;
+    }
+
+    if (player == traverser) {
+        float values[Strategy::NUM_ACTIONS] = {};
+        float nodeValue = 0;
+        for (int a = 0; a < Strategy::NUM_ACTIONS; ++a) {
+            if (!legal[a]) continue;
+            Node child = node;
+            if (!applyAction(child, static_cast<CfrAction>(a), deal, traverser, values[a])) {
+                values[a] = traverse(deal, child, traverser, rng);
+            }
+            nodeValue += strategy[a] * values[a];
+        }
+        for (int a = 0; a < Strategy::NUM_ACTIONS; ++a) {
+            if (legal[a]) atomicAdd(regrets[info][a], values[a] - nodeValue);
+        }
+        return nodeValue;
+    }
+
+    // The opponent's strategy feeds the average and one of its actions is sampled
+    for (int a = 0; a < Strategy::NUM_ACTIONS; ++a) {
+        if (legal[a]) atomicAdd(strategySums[info][a], strategy[a]);
+    }
+    float draw = static_cast<float>(rng.uniform());
+    int action = 1;
+    for (int a = 0; a < Strategy::NUM_ACTIONS; ++a) {
+        if (!legal[a]) continue;
+        action = a;
+        if (draw < strategy[a]) break;
+        draw -= strategy[a];
+    }
+    Node child = node;
+    float utility;
+    if (applyAction(child, static_cast<CfrAction>(action), deal, traverser, utility)) return utility;
+    return traverse(deal, child, traverser, rng);
+}
+
+Strategy CfrTrainer::averageStrategy() const {
+    Strategy average;
+    for (int i = 0; i < Strategy::NUM_INFOSETS; ++i) {
+        float sums[Strategy::NUM_ACTIONS];
+        float total = 0;
+        for (int a = 0; a < Strategy::NUM_ACTIONS; ++a) {
+            sums[a] = strategySums[i][a].load();
+            total += sums[a];
+        }
+        if (total <= 0) continue; // Never reached, keep the uniform strategy
+        for (float& sum : sums) {
+            sum /= total;
+        }
+        average.setProbabilities(i, sums);
+    }
+    average.setIterations(done.load());
+    return average;
+}
+
+void CfrTrainer::saveCheckpoint(const string& path) const {
+    const int count = Strategy::NUM_INFOSETS * Strategy::NUM_ACTIONS;
+    float tables[2][count];
+    for (int i = 0; i < count; ++i) {
+        tables[0][i] = (&regrets[0][0])[i].load();
+        tables[1][i] = (&strategySums[0][0])[i].load();
+    }
+    StrategyHeader header = {};
+    memcpy(header.magic, CHECKPOINT_MAGIC, 4);
+    header.version = STRATEGY_VERSION;
+    header.buckets = Strategy::BUCKETS;
+    header.maxRaises = Strategy::MAX_RAISES;
+    header.iterations = static_cast<uint64_t>(done.load());
+    header.seed = seed;
+    writeFile(path, header, &tables[0][0], 2 * count);
+}
+
+void CfrTrainer::loadCheckpoint(const string& path) {
+    const int count = Strategy::NUM_INFOSETS * Strategy::NUM_ACTIONS;
+    float tables[2][count];
+    StrategyHeader header = readFile(path, CHECKPOINT_MAGIC, &tables[0][0], 2 * count);
+    for (int i = 0; i < count; ++i) {
+        (&regrets[0][0])[i].store(tables[0][i]);
+        (&strategySums[0][0])[i].store(tables[1][i]);
+    }
+    done = static_cast<long long>(header.iterations);
+    seed = header.seed;
+}
+
+} // namespace poker
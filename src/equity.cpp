@@ -0,0 +1,294 @@
+#include "poker/equity.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "poker/deck.h"
+#include "poker/rng.h"
+
+using namespace std;
+
+namespace poker {
+
+// Integer counters gathered by one thread
+struct EquityCalculator::Tally {
+    long long wins[MAX_PLAYERS] = {};
+    long long ties[MAX_PLAYERS] = {};
+    long long shares[MAX_PLAYERS] = {};
+    long long trials = 0;
+
+    void add(const Tally& other) {
+        for (int p = 0; p < MAX_PLAYERS; ++p) {
+            wins[p] += other.wins[p];
+            ties[p] += other.ties[p];
+            shares[p] += other.shares[p];
+        }
+        trials += other.trials;
+    }
+
+    EquityResult result(int numPlayers) const {
+        EquityResult result;
+        result.trials = trials;
+        for (int p = 0; p < numPlayers && trials > 0; ++p) {
+            result.win[p] = static_cast<double>(wins[p]) / trials;
+            result.tie[p] = static_cast<double>(ties[p]) / trials;
+            result.equity[p] = static_cast<double>(shares[p]) / (static_cast<double>(trials) * SHARE_UNITS);
+        }
+        return result;
+    }
+};
+
+// The known cards of a spot and the cards still left to deal
+struct EquityCalculator::Setup {
+    Card hands[MAX_PLAYERS][2];
+    Card board[5];
+    Card pool[MAX_CARDS];
+    int numPlayers;
+    int communitySize;
+    int poolSize;
+    int cardsToDeal;
+
+    Setup(const Card holeCards[][2], int players, const Card communityCards[], int boardSize)
+        : numPlayers(players), communitySize(boardSize), poolSize(0), cardsToDeal(5 - boardSize) {
+        if (numPlayers < 2 || numPlayers > MAX_PLAYERS) {
+            throw invalid_argument("Equity needs between 2 and " + to_string(MAX_PLAYERS) + " players.");
+        }
+        if (communitySize < 0 || communitySize > 5) {
+            throw invalid_argument("A board holds at most 5 cards.");
+        }
+
+        bool used[MAX_CARDS] = {};
+        auto markUsed = [&](Card card) {
+            if (card.empty()) return;
+            if (card.code >= MAX_CARDS || used[card.code]) {
+                throw invalid_argument("Card " + card.shortName() + " is dealt twice.");
+            }
+            used[card.code] = true;
+        };
+        for (int p = 0; p < numPlayers; ++p) {
+            for (int i = 0; i < 2; ++i) {
+                hands[p][i] = holeCards[p][i];
+                markUsed(hands[p][i]);
+                if (hands[p][i].empty()) cardsToDeal++;
+            }
+        }
+        for (int i = 0; i < communitySize; ++i) {
+            if (communityCards[i].empty()) throw invalid_argument("Community cards must be known.");
+            board[i] = communityCards[i];
+            markUsed(board[i]);
+        }
+
+        Deck deck;
+        for (const Card& card : deck.cards) {
+            if (!used[card.code]) pool[poolSize++] = card;
+        }
+    }
+};
+
+// Runouts laid out for HandEvaluator::evaluateBatch(): one array per board card and per hole card
+struct EquityCalculator::Batch {
+    uint8_t board[5][BATCH_SIZE];
+    uint8_t holes[MAX_PLAYERS][2][BATCH_SIZE];
+    int scores[MAX_PLAYERS][BATCH_SIZE];
+
+    // The known cards are the same in every runout, so they are filled in once
+    explicit Batch(const Setup& setup) {
+        for (int i = 0; i < setup.communitySize; ++i) {
+            fill(board[i], board[i] + BATCH_SIZE, setup.board[i].code);
+        }
+        for (int p = 0; p < setup.numPlayers; ++p) {
+            for (int i = 0; i < 2; ++i) {
+                if (!setup.hands[p][i].empty()) fill(holes[p][i], holes[p][i] + BATCH_SIZE, setup.hands[p][i].code);
+            }
+        }
+    }
+
+    // Function to score the first size runouts for every player and credit the winners
+    void score(const HandEvaluator& evaluator, int numPlayers, int size, Tally& tally) {
+        for (int p = 0; p < numPlayers; ++p) {
+            const uint8_t* const cards[7] = { holes[p][0], holes[p][1], board[0], board[1], board[2], board[3], board[4] };
+            evaluator.evaluateBatch(cards, size, scores[p]);
+        }
+        for (int b = 0; b < size; ++b) {
+            int runout[MAX_PLAYERS];
+            for (int p = 0; p < numPlayers; ++p) runout[p] = scores[p][b];
+            tallyShowdown(runout, numPlayers, tally);
+        }
+    }
+};
+
+EquityResult EquityCalculator::monteCarlo(const Card holeCards[][2], int numPlayers, const Card communityCards[], int communitySize,
+                                          long long trials, uint64_t seed, int numThreads) {
+    Setup setup(holeCards, numPlayers, communityCards, communitySize);
+    long long numChunks = (trials + CHUNK_TRIALS - 1) / CHUNK_TRIALS;
+    Tally total = runChunks(numChunks, numThreads, [&](long long chunk, Tally& tally) {
+        long long chunkTrials = min(CHUNK_TRIALS, trials - chunk * CHUNK_TRIALS);
+        sampleChunk(setup, chunkTrials, Rng::splitMix(seed + static_cast<uint64_t>(chunk) * 0x9E3779B97F4A7C15ULL), tally);
+    });
+    return total.result(numPlayers);
+}
+
+EquityResult EquityCalculator::enumerate(const Card holeCards[][2], int numPlayers, const Card communityCards[], int communitySize,
+                                         int numThreads) {
+    Setup setup(holeCards, numPlayers, communityCards, communitySize);
+    if (setup.cardsToDeal != 5 - communitySize) {
+        throw invalid_argument("Exact equity needs every player's hole cards.");
+    }
+
+    long long numBoards = binomial(setup.poolSize, setup.cardsToDeal);
+    long long numChunks = (numBoards + CHUNK_BOARDS - 1) / CHUNK_BOARDS;
+    Tally total = runChunks(numChunks, numThreads, [&](long long chunk, Tally& tally) {
+        long long first = chunk * CHUNK_BOARDS;
+        enumerateChunk(setup, first, min(CHUNK_BOARDS, numBoards - first), tally);
+    });
+    return total.result(numPlayers);
+}
+
+long long EquityCalculator::binomial(int n, int k) {
+    static const auto table = [] {
+        array<array<long long, 8>, MAX_CARDS + 1> t{};
+        for (int i = 0; i <= MAX_CARDS; ++i) {
+            t[i][0] = 1;
+            for (int j = 1; j < 8; ++j) t[i][j] = i == 0 ? 0 : t[i - 1][j - 1] + t[i - 1][j];
+        }
+        return t;
+    }();
+    return (n < 0 || k < 0 || k >= 8) ? 0 : table[n][k];
+}
+
+// Function to spread chunks of work over threads
+//
+// Threads take the next chunk number from a shared counter until all are done, each
+// adding into its own Tally. A single thread runs on the caller's stack without
+// allocating.
+template <typename ChunkFunction>
+EquityCalculator::Tally EquityCalculator::runChunks(long long numChunks, int numThreads, const ChunkFunction& runChunk) {
+    if (numThreads <= 0) numThreads = max(1u, thread::hardware_concurrency());
+    numThreads = static_cast<int>(min<long long>(numThreads, max(1LL, numChunks)));
+
+    atomic<long long> nextChunk(0);
+    auto work = [&](Tally& tally) {
+        for (long long chunk = nextChunk++; chunk < numChunks; chunk = nextChunk++) {
+            runChunk(chunk, tally);
+        }
+    };
+
+    Tally total;
+    if (numThreads == 1) {
+        work(total);
+    }
+    else {
+        vector<Tally> tallies(numThreads);
+        vector<thread> threads;
+        for (int t = 0; t < numThreads; ++t) {
+            threads.emplace_back(work, ref(tallies[t]));
+        }
+        for (int t = 0; t < numThreads; ++t) {
+            threads[t].join();
+            total.add(tallies[t]);
+        }
+    }
+    return total;
+}
+
+// Function to credit the best score(s) of one runout
+void EquityCalculator::tallyShowdown(const int scores[], int numPlayers, Tally& tally) {
+    int bestScore = 0;
+    int numBest = 0;
+    for (int p = 0; p < numPlayers; ++p) {
+        if (scores[p] > bestScore) {
+            bestScore = scores[p];
+            numBest = 1;
+        }
+        else if (scores[p] == bestScore) {
+            numBest++;
+        }
+    }
+    for (int p = 0; p < numPlayers; ++p) {
+        if (scores[p] != bestScore) continue;
+        if (numBest == 1) tally.wins[p]++;
+        else tally.ties[p]++;
+        tally.shares[p] += SHARE_UNITS / numBest;
+    }
+    tally.trials++;
+}
+
+// Function to play out every board in a range of combination indices
+//
+// Boards are k-card combinations of the pool in colexicographic order. The first board
+// is unranked from its index, then each following board is the next combination. Boards
+// are laid out BATCH_SIZE at a time in per-card arrays so each player's hands on them are
+// scored in one HandEvaluator::evaluateBatch() call.
+void EquityCalculator::enumerateChunk(const Setup& setup, long long first, long long count, Tally& tally) {
+    const HandEvaluator& evaluator = HandEvaluator::instance();
+    int k = setup.cardsToDeal;
+    int combo[5];
+    long long rank = first;
+    for (int i = k - 1; i >= 0; --i) {
+        int x = i;
+        while (binomial(x + 1, i + 1) <= rank) x++;
+        combo[i] = x;
+        rank -= binomial(x, i + 1);
+    }
+
+    Batch batch(setup);
+    for (long long done = 0; done < count; done += BATCH_SIZE) {
+        int size = static_cast<int>(min<long long>(BATCH_SIZE, count - done));
+        for (int b = 0; b < size; ++b) {
+            for (int i = 0; i < k; ++i) {
+                batch.board[setup.communitySize + i][b] = setup.pool[combo[i]].code;
+            }
+
+            // Advance to the next combination
+            for (int i = 0; i < k; ++i) {
+                int limit = i + 1 < k ? combo[i + 1] : setup.poolSize;
+                if (combo[i] + 1 < limit) {
+                    combo[i]++;
+                    break;
+                }
+                combo[i] = i;
+            }
+        }
+        batch.score(evaluator, setup.numPlayers, size, tally);
+    }
+}
+
+// Function to play out one chunk of random runouts
+//
+// Deals the missing cards with a partial Fisher-Yates shuffle of the pool, BATCH_SIZE
+// runouts at a time, and scores each player's seven cards on the whole batch at once.
+void EquityCalculator::sampleChunk(const Setup& setup, long long chunkTrials, uint64_t seed, Tally& tally) {
+    Rng rng(seed);
+    Card pool[MAX_CARDS];
+    copy(setup.pool, setup.pool + setup.poolSize, pool);
+    const HandEvaluator& evaluator = HandEvaluator::instance();
+
+    Batch batch(setup);
+    for (long long done = 0; done < chunkTrials; done += BATCH_SIZE) {
+        int size = static_cast<int>(min<long long>(BATCH_SIZE, chunkTrials - done));
+        for (int b = 0; b < size; ++b) {
+            for (int i = 0; i < setup.cardsToDeal; ++i) {
+                int j = i + static_cast<int>(rng.below(static_cast<uint32_t>(setup.poolSize - i)));
+                swap(pool[i], pool[j]);
+            }
+
+            int dealt = 0;
+            for (int i = setup.communitySize; i < 5; ++i) {
+                batch.board[i][b] = pool[dealt++].code;
+            }
+            for (int p = 0; p < setup.numPlayers; ++p) {
+                for (int i = 0; i < 2; ++i) {
+                    if (setup.hands[p][i].empty()) batch.holes[p][i][b] = pool[dealt++].code;
+                }
+            }
+        }
+        batch.score(evaluator, setup.numPlayers, size, tally);
+    }
+}
+
+} // namespace poker
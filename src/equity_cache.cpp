@@ -0,0 +1,89 @@
+#include "poker/equity_cache.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "poker/action_log.h"
+#include "poker/equity.h"
+#include "poker/hand_indexer.h"
+#include "poker/rng.h"
+
+using namespace std;
+
+namespace poker {
+
+namespace {
+
+atomic<EquityCache*> installedCache(nullptr);
+
+} // namespace
+
+EquityCache::EquityCache(size_t entries) : mask(0), hitCount(0), missCount(0) {
+    size_t capacity = 1;
+    while (capacity < entries) capacity *= 2;
+    slots.reset(new atomic<uint64_t>[capacity]);
+    mask = capacity - 1;
+    clear();
+
+    // Build the indexers now rather than in the middle of a hand
+    for (int street = PREFLOP; street <= RIVER; ++street) {
+        HandIndexer::holdem(static_cast<Street>(street));
+    }
+}
+
+double EquityCache::equity(const Card hand[2], const Card communityCards[], int communitySize, int numOpponents,
+                           long long trials) {
+    Card holeCards[MAX_PLAYERS][2] = { { hand[0], hand[1] } };
+    if (communitySize == 1 || communitySize == 2 || communitySize > 5) {
+        // Not a street, so not a situation the cache keys
+        return EquityCalculator::monteCarlo(holeCards, numOpponents + 1, communityCards, communitySize, trials, 0, 1).equity[0];
+    }
+
+    // Key: the hand's class on its street, the street and the opponents, below 2^32 on every street
+    Street street = communitySize == 0 ? PREFLOP : static_cast<Street>(communitySize - 2);
+    const HandIndexer& indexer = HandIndexer::holdem(street);
+    Card cards[7] = { hand[0], hand[1] };
+    copy(communityCards, communityCards + communitySize, cards + 2);
+    uint64_t handIndex = indexer.index(cards);
+    uint64_t key = (handIndex * MAX_PLAYERS + static_cast<uint64_t>(numOpponents)) * 4 + street;
+
+    atomic<uint64_t>& slot = slots[Rng::splitMix(key) & mask];
+    uint64_t entry = slot.load(memory_order_relaxed);
+    float value;
+    if (entry >> 32 == key + 1) {
+        uint32_t bits = static_cast<uint32_t>(entry);
+        memcpy(&value, &bits, sizeof(value));
+        hitCount.fetch_add(1, memory_order_relaxed);
+        return value;
+    }
+
+    // Compute for the canonical hand so the result is the same whichever hand of the class missed
+    indexer.unindex(handIndex, cards);
+    holeCards[0][0] = cards[0];
+    holeCards[0][1] = cards[1];
+    value = static_cast<float>(EquityCalculator::monteCarlo(holeCards, numOpponents + 1, cards + 2, communitySize, trials,
+                                                            Rng::splitMix(key), 1).equity[0]);
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    slot.store((key + 1) << 32 | bits, memory_order_relaxed);
+    missCount.fetch_add(1, memory_order_relaxed);
+    return value;
+}
+
+void EquityCache::clear() {
+    for (size_t i = 0; i <= mask; ++i) {
+        slots[i].store(0, memory_order_relaxed);
+    }
+    hitCount.store(0);
+    missCount.store(0);
+}
+
+void EquityCache::install(EquityCache* equityCache) {
+    installedCache.store(equityCache);
+}
+
+EquityCache* EquityCache::installed() {
+    return installedCache.load(memory_order_acquire);
+}
+
+} // namespace poker
@@ -0,0 +1,52 @@
+#include "poker/file_io.h"
+
+#include <cstdio>
+#include <stdexcept>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <unistd.h>
+#define POKER_HAVE_FSYNC 1
+#endif
+
+using namespace std;
+
+namespace poker {
+
+void writeFileAtomically(const string& path, initializer_list<FilePart> parts) {
+    string tempPath = path + ".tmp";
+    FILE* file = fopen(tempPath.c_str(), "wb");
+    if (!file) {
+        throw runtime_error("Cannot open " + tempPath + " for writing.");
+    }
+    bool written = true;
+    for (const FilePart& part : parts) {
+        written = written && fwrite(part.data, 1, part.size, file) == part.size;
+    }
+    written = written && fflush(file) == 0;
+#ifdef POKER_HAVE_FSYNC
+    written = written && fsync(fileno(file)) == 0;
+#endif
+    written = fclose(file) == 0 && written;
+    if (!written || rename(tempPath.c_str(), path.c_str()) != 0) {
+        remove(tempPath.c_str());
+        throw runtime_error("Cannot write " + path + ".");
+    }
+    syncDirectory(path);
+}
+
+void syncDirectory(const string& path) {
+#ifdef POKER_HAVE_FSYNC
+    size_t slash = path.find_last_of('/');
+    string directory = slash == string::npos ? "." : (slash == 0 ? "/" : path.substr(0, slash));
+    int fd = open(directory.c_str(), O_RDONLY);
+    if (fd >= 0) {
+        fsync(fd);
+        close(fd);
+    }
+#else
+    (void)path;
+#endif
+}
+
+} // namespace poker
@@ -0,0 +1,368 @@
+#include "poker/game.h"
+
+#include "poker/rankings.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <stdexcept>
+
+using namespace std;
+
+namespace poker {
+
+void displayPot(int pot) {
+    cout << "The current pot is: " << pot << " chips." << endl;
+}
+
+void displayBettingHistory(const ActionLog& actionLog, const Player players[]) {
+    static const char* streetNames[] = { "Preflop", "Flop", "Turn", "River" };
+    cout << "Betting History for this hand:\n";
+    for (int i = 0; i < actionLog.size(); ++i) {
+        const ActionRecord& action = actionLog[i];
+        cout << streetNames[action.street] << ": " << ActionLog::describe(action, players[action.seat].name) << endl;
+    }
+}
+
+void saveGameState(const Player players[], int numPlayers, const SessionState& session) {
+    try {
+        writeGameState(GAME_STATE_PATH, players, numPlayers, session);
+        cout << "Game state saved successfully." << endl;
+    }
+    catch (const exception& e) {
+        cout << "Unable to save game state: " << e.what() << endl;
+    }
+}
+
+bool loadGameState(Player players[], int& numPlayers, SessionState& session) {
+    try {
+        if (readGameState(GAME_STATE_PATH, players, numPlayers, session)) {
+            cout << "Game state loaded successfully." << endl;
+            return true;
+        }
+        cout << "Unable to load game state: there is no saved game." << endl;
+    }
+    catch (const exception& e) {
+        cout << "Unable to load game state: " << e.what() << endl;
+    }
+    return false;
+}
+
+void betInter(Player players[], int numPlayers, int currentBet, long long hand, InterGraph& interactions) {
+    for (int i = 0; i < numPlayers; ++i) {
+        if (!players[i].folded) { // Only include players still in the game
+            for (int j = i + 1; j < numPlayers; ++j) {
+                if (!players[j].folded) {
+                    // Add interaction between players[i] and players[j]
+                    interactions.addInter(players[i].id, players[j].id, currentBet, hand);
+                }
+            }
+        }
+    }
+}
+
+void handInter(const Table& table, long long hand, InterGraph& interactions) {
+    int numSeats = table.numPlayers();
+    int net[MAX_PLAYERS];
+    long long lost = 0;
+    for (int seat = 0; seat < numSeats; ++seat) {
+        net[seat] = table.payout(seat) - table.pots().contributed(seat);
+        if (net[seat] < 0) lost -= net[seat];
+    }
+    bool showdown = table.activePlayers() > 1;
+
+    for (int i = 0; i < numSeats; ++i) {
+        if (!table.dealtIn(i)) continue;
+        const Player& first = table.player(i);
+        for (int j = i + 1; j < numSeats; ++j) {
+            if (!table.dealtIn(j)) continue;
+            const Player& second = table.player(j);
+            interactions.addHand(first.id, second.id, hand);
+            if (showdown && !first.folded && !second.folded) {
+                interactions.addShowdown(first.id, second.id, table.won(i), table.won(j));
+            }
+            if (net[i] > 0 && net[j] < 0) {
+                interactions.addFlow(first.id, second.id, static_cast<int>(net[i] * static_cast<long long>(-net[j]) / lost));
+            }
+            else if (net[j] > 0 && net[i] < 0) {
+                interactions.addFlow(second.id, first.id, static_cast<int>(net[j] * static_cast<long long>(-net[i]) / lost));
+            }
+        }
+    }
+}
+
+void assignPlayerIds(Player players[], int numPlayers, InterGraph& interactions) {
+    bool taken[MAX_PLAYERS] = {};
+    for (int i = 0; i < numPlayers; ++i) {
+        int id = players[i].id;
+        if (id < 0 || id >= MAX_PLAYERS || taken[id]) players[i].id = -1;
+        else taken[id] = true;
+    }
+    for (int i = 0; i < numPlayers; ++i) {
+        if (players[i].id < 0) {
+            int id = 0;
+            while (taken[id]) ++id;
+            players[i].id = id;
+            taken[id] = true;
+        }
+        interactions.setName(players[i].id, players[i].name);
+    }
+}
+
+int countActivePlayers(Player players[], int numPlayers) {
+    return static_cast<int>(count_if(players, players + numPlayers, [](Player& p) { return !p.folded; }));
+}
+
+EquityResult activePlayersEquity(const Player players[], int numPlayers, const Card communityCards[], int communitySize) {
+    Card holeCards[MAX_PLAYERS][2];
+    int seats[MAX_PLAYERS];
+    int numActive = 0;
+    for (int i = 0; i < numPlayers; ++i) {
+        if (players[i].folded) continue;
+        holeCards[numActive][0] = players[i].hand[0];
+        holeCards[numActive][1] = players[i].hand[1];
+        seats[numActive++] = i;
+    }
+
+    EquityResult active = EquityCalculator::enumerate(holeCards, numActive, communityCards, communitySize);
+    EquityResult bySeat;
+    bySeat.trials = active.trials;
+    for (int i = 0; i < numActive; ++i) {
+        bySeat.win[seats[i]] = active.win[i];
+        bySeat.tie[seats[i]] = active.tie[i];
+        bySeat.equity[seats[i]] = active.equity[i];
+    }
+    return bySeat;
+}
+
+void displayEquities(const Player players[], int numPlayers, const Card communityCards[], int communitySize) {
+    EquityResult result = activePlayersEquity(players, numPlayers, communityCards, communitySize);
+    for (int i = 0; i < numPlayers; ++i) {
+        if (players[i].folded) continue;
+        cout << "  " << players[i].name << " (" << players[i].hand[0].shortName() << players[i].hand[1].shortName()
+             << "): win " << result.win[i] * 100 << "%  tie " << result.tie[i] * 100 << "%  equity "
+             << result.equity[i] * 100 << "%" << endl;
+    }
+}
+
+void recursiveComcard(const Card communityCards[], int index, int totalCards) {
+    if (index >= totalCards) return; // Base case: No more cards to display
+
+    // Display the current card
+    cout << communityCards[index].rank() << " of " << communityCards[index].suit();
+
+  
+    if (index < totalCards - 1) cout << ", ";
+
+    // Recursive call for the next card
+    recursiveComcard(communityCards, index + 1, totalCards);
+}
+
+bool isBot(const Player& player) {
+    return player.name.find("Bot") != string::npos;
+}
+
+void displayHandResult(const Table& table, const function<void(int)>& pause) {
+    if (table.activePlayers() == 1) {
+        const Player& winner = table.player(table.winner());
+        cout << "\nEveryone else folded. " << winner.name << " wins the pot of " << table.potWon() << " chips!" << endl;
+        return;
+    }
+
+    cout << "\nShowdown! Evaluating hands..." << endl;
+    if (pause) pause(2);
+    for (int i = 0; i < table.numPlayers(); ++i) {
+        Player& player = table.player(i);
+        if (player.folded) continue;
+        int score = player.evaluateHandStrength(table.board(), table.boardSize());
+        player.showHand();  // Reveal bot hands during showdown
+        cout << player.name << " has " << HandEvaluator::categoryName(score) << " (hand score " << score << ")." << endl;
+    }
+
+    // Announce each pot, main pot first
+    const SidePots& pots = table.pots();
+    for (int p = 0; p < pots.size(); ++p) {
+        if ((pots[p].contributors & (pots[p].contributors - 1)) == 0) {
+            // Nobody called this much, so it goes back to the one who bet it
+            for (int i = 0; i < table.numPlayers(); ++i) {
+                if (pots[p].contributors >> i & 1) cout << table.player(i).name << " takes back " << pots[p].amount << " uncalled chips." << endl;
+            }
+            continue;
+        }
+        string potName = p == 0 ? "the main pot" : "side pot " + to_string(p);
+        string winners;
+        int numWinners = 0;
+        for (int i = 0; i < table.numPlayers(); ++i) {
+            if (!(pots[p].winners >> i & 1)) continue;
+            winners += (numWinners++ > 0 ? " and " : "") + table.player(i).name;
+        }
+        cout << winners << (numWinners > 1 ? " split " : " wins ") << potName << " of " << pots[p].amount << " chips!" << endl;
+    }
+}
+
+long long gameLoop(Player players[], int numPlayers, Deck& deck, InterGraph& interactions, const GameOptions& options) {
+    static const char* streetNames[] = { "Preflop", "Flop", "Turn", "River" };
+    static const char* roundNames[] = { "Betting Round", "Betting Round 2", "Betting Round 3", "Final Betting Round" };
+    static const int boardSizes[] = { 0, 3, 4, 5 };
+
+    const bool verbose = !options.headless;
+    const bool allBots = all_of(players, players + numPlayers, isBot);
+    if (options.headless && !allBots) {
+        throw invalid_argument("Headless games can only be played by bots.");
+    }
+    if (!allBots && !options.humanAction) {
+        throw invalid_argument("Games with human players need GameOptions::humanAction.");
+    }
+
+    Table table(deck);
+    long long handsPlayed = 0;
+    auto start = chrono::steady_clock::now();
+    const uint64_t sessionSeed = options.resume ? options.resume->seed : options.seed != 0 ? options.seed : Rng::randomSeed();
+    const long long firstHand = options.resume ? options.resume->handsPlayed : 0; // Hands before this session
+
+    if (verbose) cout << "\nSession seed: " << sessionSeed << " (replay with --seed " << sessionSeed << ")" << endl;
+
+    // Key the players in the interaction graph by ids that last across sessions
+    assignPlayerIds(players, numPlayers, interactions);
+    int button = options.resume && options.resume->button < numPlayers ? options.resume->button : -1;
+
+    // Main game loop runs until only one player has chips remaining or the budget runs out
+    while (count_if(players, players + numPlayers, [](Player& p) { return p.chips > 0; }) > 1) {
+        if (options.maxHands > 0 && handsPlayed >= options.maxHands) break;
+        if (options.maxSeconds > 0 && chrono::duration<double>(chrono::steady_clock::now() - start).count() >= options.maxSeconds) break;
+        handsPlayed++;
+        const long long handNumber = firstHand + handsPlayed;
+
+        if (verbose) cout << "\nNew Round Begins!" << endl;
+        const uint64_t handSeed = Rng::splitMix(sessionSeed + static_cast<uint64_t>(handNumber) * 0x9E3779B97F4A7C15ULL);
+        // Players stay in their seats all game; the button moves to the next seat with chips
+        do {
+            button = (button + 1) % numPlayers;
+        } while (players[button].chips <= 0);
+        table.startHand(players, numPlayers, button, handSeed);
+
+        // Show each player's hand (hiding bot cards initially)
+        if (verbose) {
+            cout << players[button].name << " has the dealer button." << endl;
+            for (int i = 0; i < numPlayers; ++i) {
+                if (table.dealtIn(i)) players[i].showHand(isBot(players[i]));
+            }
+            cout << "\n" << roundNames[PREFLOP] << " Begins" << endl;
+        }
+
+        // Answer the table's decisions until the hand is over
+        Street street = PREFLOP;
+        while (!table.handOver()) {
+            Player& actor = players[table.decision().seat];
+            int streetBet = table.decision().currentBet;
+            Action action = isBot(actor) ? botAction(table, options.strategy) : options.humanAction(table);
+            try {
+                table.apply(action);
+            }
+            catch (const invalid_argument& e) {
+                if (isBot(actor)) throw;
+                cout << e.what() << endl; // Ask the human again
+                continue;
+            }
+            if (!table.handOver() && table.decision().street == street) continue;
+
+            // A betting round closed: log the interactions and show the cards dealt since
+            betInter(players, numPlayers, streetBet, handNumber, interactions);
+            if (!verbose) {
+                street = table.decision().street;
+                continue;
+            }
+            displayPot(table.handOver() ? table.potWon() : table.decision().pot);
+            // Nobody can bet any more but several players are left: the hands are turned up before the runout
+            if (table.handOver() && table.activePlayers() > 1 && boardSizes[street] < 5) {
+                cout << "\nNo more betting. The odds before the rest of the board:" << endl;
+                displayEquities(players, numPlayers, table.board(), boardSizes[street]);
+            }
+            bool dealt = false;
+            while (street < RIVER && table.boardSize() >= boardSizes[street + 1]) {
+                street = static_cast<Street>(street + 1);
+                cout << "\nDealing the " << streetNames[street] << "..." << endl;
+                dealt = true;
+            }
+            if (dealt) {
+                if (options.pause) options.pause(1);
+                cout << "Community cards: ";
+                recursiveComcard(table.board(), 0, table.boardSize());
+                cout << endl;
+                // With only bots at the table nothing is hidden from the spectator, so show the odds on every street
+                if (allBots && !table.handOver()) displayEquities(players, numPlayers, table.board(), table.boardSize());
+            }
+            if (!table.handOver()) cout << "\n" << roundNames[street] << " Begins" << endl;
+        }
+
+        handInter(table, handNumber, interactions);
+        if (options.leaderboard) {
+            for (int i = 0; i < numPlayers; ++i) {
+                options.leaderboard->update(static_cast<uint32_t>(players[i].id), players[i].chips);
+            }
+        }
+        if (verbose) {
+            displayBettingHistory(table.actions(), players);
+            displayHandResult(table, options.pause);
+        }
+
+        // Record the hand
+        if (options.history) {
+            HandRecord hand = {};
+            hand.table = options.table;
+            hand.handNumber = static_cast<uint64_t>(handNumber);
+            hand.seed = handSeed;
+            hand.pot = table.potWon();
+            hand.numSeats = static_cast<uint8_t>(numPlayers);
+            hand.boardSize = static_cast<uint8_t>(table.boardSize());
+            hand.winner = static_cast<int8_t>(table.winner());
+            for (int i = 0; i < table.boardSize(); ++i) {
+                hand.board[i] = table.board()[i];
+            }
+            for (int i = 0; i < numPlayers; ++i) {
+                players[i].name.copy(hand.names[i], sizeof(hand.names[i]) - 1);
+                hand.holeCards[i][0] = players[i].hand[0];
+                hand.holeCards[i][1] = players[i].hand[1];
+            }
+            options.history->writeHand(hand, table.actions());
+        }
+
+        // Eliminate players who have run out of chips; they keep their seats and sit the next hands out
+        for (int i = 0; i < numPlayers; ++i) {
+            if (players[i].chips == 0 && table.dealtIn(i)) {
+                players[i].folded = true;
+                if (verbose) cout << players[i].name << " is eliminated from the game." << endl;
+            }
+        }
+
+        if (!verbose) continue;
+
+        // Let whoever drives the game stop it or save it between hands
+        if (options.continuePlaying && !options.continuePlaying()) {
+            cout << "Exiting the game..." << endl;
+            return handsPlayed;
+        }
+        if (options.onSave) {
+            SessionState session;
+            session.seed = sessionSeed;
+            session.handsPlayed = handNumber;
+            session.button = button;
+            options.onSave(players, numPlayers, session);
+        }
+    }
+
+    // Announce the game winner and the final standings
+    if (verbose) {
+        int order[MAX_PLAYERS];
+        rankPlayers(players, numPlayers, order);
+        cout << "\nGame Over!" << endl;
+        for (int i = 0; i < numPlayers; ++i) {
+            const Player& player = players[order[i]];
+            if (i == 0) cout << player.name << " is the winner with " << player.chips << " chips." << endl;
+            else cout << (i + 1) << ". " << player.name << " with " << player.chips << " chips." << endl;
+        }
+    }
+    return handsPlayed;
+}
+
+} // namespace poker
@@ -0,0 +1,193 @@
+#include "poker/game_state.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <vector>
+
+#include "poker/file_io.h"
+
+using namespace std;
+
+namespace poker {
+
+namespace {
+
+// Struct for the CRC-32 (IEEE) of every byte value
+struct CrcTable {
+    uint32_t values[256];
+
+    constexpr CrcTable() : values() {
+        for (uint32_t byte = 0; byte < 256; ++byte) {
+            uint32_t crc = byte;
+            for (int bit = 0; bit < 8; ++bit) {
+                crc = (crc & 1) ? 0xEDB88320u ^ (crc >> 1) : crc >> 1;
+            }
+            values[byte] = crc;
+        }
+    }
+};
+
+constexpr CrcTable CRC_TABLE;
+
+uint32_t crc32(const char* data, size_t length) {
+    uint32_t crc = 0xFFFFFFFFu;
+    for (size_t i = 0; i < length; ++i) {
+        crc = CRC_TABLE.values[(crc ^ static_cast<uint8_t>(data[i])) & 0xFF] ^ (crc >> 8);
+    }
+    return crc ^ 0xFFFFFFFFu;
+}
+
+template <typename T>
+void put(vector<char>& out, const T& value) {
+    const char* bytes = reinterpret_cast<const char*>(&value);
+    out.insert(out.end(), bytes, bytes + sizeof(T));
+}
+
+// Function to start a record, returning where its length goes once the payload is written
+size_t beginRecord(vector<char>& out, GameStateTag tag) {
+    GameStateRecordHeader header = { tag, 0, 0 };
+    put(out, header);
+    return out.size() - sizeof(header.length);
+}
+
+void endRecord(vector<char>& out, size_t lengthAt) {
+    uint32_t length = static_cast<uint32_t>(out.size() - lengthAt - sizeof(uint32_t));
+    memcpy(out.data() + lengthAt, &length, sizeof(length));
+}
+
+// Struct for reading the fields of a record payload; fields past its end keep their defaults
+struct PayloadReader {
+    const char* data;
+    uint32_t length;
+    uint32_t offset;
+
+    template <typename T>
+    void get(T& value) {
+        if (offset + sizeof(T) <= length) memcpy(&value, data + offset, sizeof(T));
+        offset += sizeof(T);
+    }
+};
+
+} // namespace
+
+void writeGameState(const string& path, const Player players[], int numPlayers, const SessionState& session) {
+    vector<char> out;
+    GameStateHeader header = {};
+    memcpy(header.magic, GAME_STATE_MAGIC, 4);
+    header.version = GAME_STATE_VERSION;
+    put(out, header);
+
+    size_t lengthAt = beginRecord(out, GAME_STATE_SESSION);
+    put(out, session.seed);
+    put(out, static_cast<uint64_t>(session.handsPlayed));
+    put(out, static_cast<int32_t>(session.button));
+    endRecord(out, lengthAt);
+
+    for (int i = 0; i < numPlayers; ++i) {
+        const Player& player = players[i];
+        lengthAt = beginRecord(out, GAME_STATE_PLAYER);
+        put(out, static_cast<int32_t>(player.chips));
+        put(out, static_cast<int32_t>(player.gamesWon));
+        put(out, static_cast<int32_t>(player.handsPlayed));
+        put(out, static_cast<int32_t>(player.handsWon));
+        put(out, static_cast<int32_t>(player.id));
+        uint16_t nameLength = static_cast<uint16_t>(min<size_t>(player.name.size(), UINT16_MAX));
+        put(out, nameLength);
+        out.insert(out.end(), player.name.data(), player.name.data() + nameLength);
+        endRecord(out, lengthAt);
+    }
+
+    lengthAt = beginRecord(out, GAME_STATE_END);
+    put(out, crc32(out.data(), out.size() - sizeof(GameStateRecordHeader)));
+    endRecord(out, lengthAt);
+
+    // Write beside the old save and swap it in only once the new one is safely on disk
+    writeFileAtomically(path, { { out.data(), out.size() } });
+}
+
+bool readGameState(const string& path, Player players[], int& numPlayers, SessionState& session) {
+    ifstream in(path, ios::binary);
+    if (!in) {
+        return false;
+    }
+    vector<char> contents((istreambuf_iterator<char>(in)), istreambuf_iterator<char>());
+
+    GameStateHeader header;
+    if (contents.size() < sizeof(header) || memcmp(contents.data(), GAME_STATE_MAGIC, 4) != 0) {
+        throw runtime_error(path + " is not a saved game.");
+    }
+    memcpy(&header, contents.data(), sizeof(header));
+    if (header.version > GAME_STATE_VERSION) {
+        throw runtime_error(path + " was saved by a newer version (format " + to_string(header.version) + ").");
+    }
+
+    // Read into locals so a damaged file leaves the caller's players alone
+    Player loaded[MAX_PLAYERS];
+    int numLoaded = 0;
+    SessionState loadedSession;
+    bool ended = false;
+    size_t offset = sizeof(header);
+    while (!ended) {
+        GameStateRecordHeader record;
+        if (contents.size() - offset < sizeof(record)) break;
+        memcpy(&record, contents.data() + offset, sizeof(record));
+        size_t start = offset;
+        offset += sizeof(record);
+        if (contents.size() - offset < record.length) break;
+        PayloadReader payload = { contents.data() + offset, record.length, 0 };
+        offset += record.length;
+
+        if (record.tag == GAME_STATE_END) {
+            uint32_t crc = 0;
+            payload.get(crc);
+            if (crc != crc32(contents.data(), start)) {
+                throw runtime_error(path + " is damaged (checksum mismatch).");
+            }
+            ended = true;
+        }
+        else if (record.tag == GAME_STATE_SESSION) {
+            uint64_t handsPlayed = 0;
+            int32_t button = -1;
+            payload.get(loadedSession.seed);
+            payload.get(handsPlayed);
+            payload.get(button);
+            loadedSession.handsPlayed = static_cast<long long>(handsPlayed);
+            loadedSession.button = button;
+        }
+        else if (record.tag == GAME_STATE_PLAYER) {
+            if (numLoaded == MAX_PLAYERS) {
+                throw runtime_error(path + " has more than " + to_string(MAX_PLAYERS) + " players.");
+            }
+            Player& player = loaded[numLoaded++];
+            int32_t fields[5] = { player.chips, 0, 0, 0, -1 };
+            for (int32_t& field : fields) payload.get(field);
+            uint16_t nameLength = 0;
+            payload.get(nameLength);
+            if (payload.offset + nameLength > payload.length) {
+                throw runtime_error(path + " is damaged (player name out of bounds).");
+            }
+            player.chips = fields[0];
+            player.gamesWon = fields[1];
+            player.handsPlayed = fields[2];
+            player.handsWon = fields[3];
+            player.id = fields[4];
+            player.name.assign(payload.data + payload.offset, nameLength);
+        }
+        // Any other tag was added by a later version and is skipped
+    }
+    if (!ended) {
+        throw runtime_error(path + " is damaged (cut short).");
+    }
+
+    for (int i = 0; i < numLoaded; ++i) {
+        players[i] = loaded[i];
+    }
+    numPlayers = numLoaded;
+    session = loadedSession;
+    return true;
+}
+
+} // namespace poker
@@ -0,0 +1,297 @@
+#include "poker/hand_evaluator.h"
+
+#include <algorithm>
+#include <functional>
+#include <iterator>
+
+#if !defined(POKER_DISABLE_AVX2) && (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#include <immintrin.h>
+#define POKER_HAVE_AVX2 1
+#endif
+
+using namespace std;
+
+namespace poker {
+
+namespace {
+
+// Calls visit() for every way to place numCards cards on ranks rank..12, at most 4 per rank
+void forEachRankMultiset(int counts[], int rank, int numCards, const function<void()>& visit) {
+    if (rank == 13) {
+        if (numCards == 0) visit();
+        return;
+    }
+    for (int c = 0; c <= 4 && c <= numCards; ++c) {
+        counts[rank] = c;
+        forEachRankMultiset(counts, rank + 1, numCards - c, visit);
+    }
+    counts[rank] = 0;
+}
+
+// Calls visit() for every sub-multiset of counts holding exactly numCards cards
+void forEachSubset(const int counts[], int subset[], int rank, int numCards, const function<void()>& visit) {
+    if (rank == 13) {
+        if (numCards == 0) visit();
+        return;
+    }
+    for (int c = 0; c <= counts[rank] && c <= numCards; ++c) {
+        subset[rank] = c;
+        forEachSubset(counts, subset, rank + 1, numCards - c, visit);
+    }
+    subset[rank] = 0;
+}
+
+// Function to compute a comparable key for exactly five cards
+//
+// The key is the category in the top bits followed by the tie-break ranks,
+// most significant first, four bits each.
+//
+// Parameters:
+// - const int counts[]: Number of cards of each rank (sums to 5).
+// - bool suited: Whether all five cards share a suit.
+//
+// Returns:
+// - uint32_t: A key where a larger value means a stronger hand.
+uint32_t rawValue(const int counts[], bool suited) {
+    // Order ranks by how often they appear, then by rank
+    int order[5];
+    int n = 0;
+    for (int count = 4; count >= 1; --count) {
+        for (int rank = 12; rank >= 0; --rank) {
+            if (counts[rank] == count) order[n++] = rank;
+        }
+    }
+
+    int topOfStraight = -1;
+    if (n == 5) {
+        if (order[0] - order[4] == 4) topOfStraight = order[0];
+        else if (order[0] == 12 && order[1] == 3) topOfStraight = 3;  // Five-high wheel
+    }
+
+    HandCategory category;
+    if (topOfStraight >= 0) category = suited ? STRAIGHT_FLUSH : STRAIGHT;
+    else if (suited) category = FLUSH;
+    else if (counts[order[0]] == 4) category = FOUR_OF_A_KIND;
+    else if (counts[order[0]] == 3) category = counts[order[1]] == 2 ? FULL_HOUSE : THREE_OF_A_KIND;
+    else if (counts[order[0]] == 2) category = counts[order[1]] == 2 ? TWO_PAIR : ONE_PAIR;
+    else category = HIGH_CARD;
+
+    uint32_t raw = static_cast<uint32_t>(category) << 20;
+    if (topOfStraight >= 0) return raw | (topOfStraight << 16);
+    for (int i = 0; i < n; ++i) raw |= order[i] << (16 - 4 * i);
+    return raw;
+}
+
+} // namespace
+
+const char* HandEvaluator::categoryName(int value) {
+    static const char* names[] = { "High Card", "One Pair", "Two Pair", "Three of a Kind", "Straight",
+                                   "Flush", "Full House", "Four of a Kind", "Straight Flush" };
+    return names[category(value)];
+}
+
+// Builds every lookup table
+HandEvaluator::HandEvaluator() {
+    // ways[n][k]: number of ways to spread k cards over n ranks with at most 4 per rank
+    uint32_t ways[14][8] = {};
+    ways[0][0] = 1;
+    for (int n = 1; n <= 13; ++n) {
+        for (int k = 0; k < 8; ++k) {
+            for (int c = 0; c <= 4 && c <= k; ++c) {
+                ways[n][k] += ways[n - 1][k - c];
+            }
+        }
+    }
+    for (int rank = 0; rank < 13; ++rank) {
+        for (int k = 0; k < 8; ++k) {
+            uint32_t sum = 0;
+            for (int c = 0; c < 5; ++c) {
+                hashTerms[rank][k][c] = sum;
+                if (c <= k) sum += ways[12 - rank][k - c];
+            }
+        }
+    }
+
+    // Rank every 5-card equivalence class by its raw comparison key
+    vector<uint32_t> rawValues;
+    rawValues.reserve(NUM_CLASSES);
+    int counts[13] = {};
+    forEachRankMultiset(counts, 0, 5, [&]() {
+        rawValues.push_back(rawValue(counts, false));
+        if (*max_element(counts, counts + 13) == 1) rawValues.push_back(rawValue(counts, true));
+    });
+    sort(rawValues.begin(), rawValues.end());
+    auto denseValue = [&](uint32_t raw) {
+        return static_cast<uint16_t>(lower_bound(rawValues.begin(), rawValues.end(), raw) - rawValues.begin() + 1);
+    };
+
+    // Flushes: take the best five cards of the suited rank mask
+    fill(begin(flushTable), end(flushTable), 0);
+    for (int mask = 0; mask < 8192; ++mask) {
+        int bits = 0;
+        for (int rank = 0; rank < 13; ++rank) bits += (mask >> rank) & 1;
+        if (bits < 5) continue;
+
+        int best[13] = {};
+        uint32_t bestRaw = 0;
+        // Straight flushes first, then the five highest suited cards
+        for (int top = 12; top >= 3 && bestRaw == 0; --top) {
+            int straight = top == 3 ? (0x100F) : (0x1F << (top - 4));
+            if ((mask & straight) == straight) {
+                fill(best, best + 13, 0);
+                for (int rank = 0; rank < 13; ++rank) best[rank] = (straight >> rank) & 1;
+                bestRaw = rawValue(best, true);
+            }
+        }
+        if (bestRaw == 0) {
+            fill(best, best + 13, 0);
+            for (int rank = 12, taken = 0; rank >= 0 && taken < 5; --rank) {
+                if ((mask >> rank) & 1) {
+                    best[rank] = 1;
+                    taken++;
+                }
+            }
+            bestRaw = rawValue(best, true);
+        }
+        flushTable[mask] = denseValue(bestRaw);
+    }
+
+    // Everything else: best 5-card subset of each rank multiset
+    for (int numCards = 5; numCards <= 7; ++numCards) {
+        // One spare entry so 32-bit gathers of the last one stay inside
+        noFlushTables[numCards].assign(ways[13][numCards] + 1, 0);
+        fill(counts, counts + 13, 0);
+        forEachRankMultiset(counts, 0, numCards, [&]() {
+            uint32_t bestRaw = 0;
+            int subset[13] = {};
+            forEachSubset(counts, subset, 0, 5, [&]() {
+                bestRaw = max(bestRaw, rawValue(subset, false));
+            });
+            uint32_t hash = 0;
+            int remaining = numCards;
+            for (int rank = 0; rank < 13; ++rank) {
+                hash += hashTerms[rank][remaining][counts[rank]];
+                remaining -= counts[rank];
+            }
+            noFlushTables[numCards][hash] = denseValue(bestRaw);
+        });
+    }
+}
+
+void HandEvaluator::evaluateBatch(const uint8_t* const cards[7], int numHands, int values[]) const {
+    if (usesAvx2()) {
+        evaluateBatchAvx2(cards, numHands, values);
+    }
+    else {
+        evaluateBatchScalar(cards, numHands, values);
+    }
+}
+
+void HandEvaluator::evaluateBatchScalar(const uint8_t* const cards[7], int numHands, int values[]) const {
+    for (int h = 0; h < numHands; ++h) {
+        HandState state;
+        for (int i = 0; i < 7; ++i) {
+            state.add(Card(cards[i][h]));
+        }
+        values[h] = evaluate(state);
+    }
+}
+
+#ifdef POKER_HAVE_AVX2
+
+bool HandEvaluator::usesAvx2() {
+    static const bool available = __builtin_cpu_supports("avx2");
+    return available;
+}
+
+// Scores eight hands per step, one per 32-bit lane, with the same steps as evaluate(). The card
+// counts are kept in bit fields so each rank or suit count is a shift and a mask: 3 bits per rank
+// (ranks 0-9 in one word, 10-12 in another) and 8 bits per suit. The tables are read with gathers.
+// Only compiled for AVX2, and only called when the CPU has it.
+__attribute__((target("avx2"))) void HandEvaluator::evaluateBatchAvx2(const uint8_t* const cards[7], int numHands,
+                                                                       int values[]) const {
+    const int* hashTable = reinterpret_cast<const int*>(&hashTerms[0][0][0]);
+    const int* flushValues = reinterpret_cast<const int*>(flushTable);
+    const int* noFlushValues = reinterpret_cast<const int*>(noFlushTables[7].data());
+    const __m256i one = _mm256_set1_epi32(1);
+    const __m256i three = _mm256_set1_epi32(3);
+    const __m256i four = _mm256_set1_epi32(4);
+    const __m256i seven = _mm256_set1_epi32(7);
+    const __m256i byte = _mm256_set1_epi32(0xFF);
+    const __m256i lowHalf = _mm256_set1_epi32(0xFFFF);
+    const __m256i highRanks = _mm256_set1_epi32(30);
+
+    int h = 0;
+    for (; h + 8 <= numHands; h += 8) {
+        __m256i suits[7];
+        __m256i rankBits[7];
+        __m256i lowCounts = _mm256_setzero_si256();
+        __m256i highCounts = _mm256_setzero_si256();
+        __m256i suitCounts = _mm256_setzero_si256();
+        for (int i = 0; i < 7; ++i) {
+            __m256i code = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(cards[i] + h)));
+            __m256i rank = _mm256_srli_epi32(code, 2);
+            __m256i rankShift = _mm256_add_epi32(rank, _mm256_add_epi32(rank, rank));
+            suits[i] = _mm256_and_si256(code, three);
+            rankBits[i] = _mm256_sllv_epi32(one, rank);
+
+            // Shifts of 32 or more (and negative ones) give 0, which keeps each card in one word
+            lowCounts = _mm256_add_epi32(lowCounts, _mm256_sllv_epi32(one, rankShift));
+            highCounts = _mm256_add_epi32(highCounts, _mm256_sllv_epi32(one, _mm256_sub_epi32(rankShift, highRanks)));
+            suitCounts = _mm256_add_epi32(suitCounts, _mm256_sllv_epi32(one, _mm256_slli_epi32(suits[i], 3)));
+        }
+
+        // With at most 7 cards only one suit can hold five, and its ranks index the flush table
+        __m256i hasFlush = _mm256_setzero_si256();
+        __m256i flushSuit = _mm256_setzero_si256();
+        for (int suit = 0; suit < 4; ++suit) {
+            __m256i count = _mm256_and_si256(_mm256_srli_epi32(suitCounts, 8 * suit), byte);
+            __m256i flush = _mm256_cmpgt_epi32(count, four);
+            hasFlush = _mm256_or_si256(hasFlush, flush);
+            flushSuit = _mm256_or_si256(flushSuit, _mm256_and_si256(flush, _mm256_set1_epi32(suit)));
+        }
+        __m256i flushMask = _mm256_setzero_si256();
+        for (int i = 0; i < 7; ++i) {
+            flushMask = _mm256_or_si256(flushMask, _mm256_and_si256(_mm256_cmpeq_epi32(suits[i], flushSuit), rankBits[i]));
+        }
+        flushMask = _mm256_and_si256(flushMask, hasFlush);
+        __m256i flushValue = _mm256_and_si256(_mm256_i32gather_epi32(flushValues, flushMask, 2), lowHalf);
+
+        // hash += hashTerms[rank][remaining][count], laid out as rank * 40 + remaining * 5 + count
+        __m256i hash = _mm256_setzero_si256();
+        __m256i remaining = seven;
+        for (int rank = 0; rank < 13; ++rank) {
+            __m256i count = rank < 10 ? _mm256_and_si256(_mm256_srli_epi32(lowCounts, 3 * rank), seven)
+                                      : _mm256_and_si256(_mm256_srli_epi32(highCounts, 3 * (rank - 10)), seven);
+            __m256i index = _mm256_add_epi32(_mm256_set1_epi32(rank * 40),
+                                             _mm256_add_epi32(_mm256_add_epi32(_mm256_slli_epi32(remaining, 2), remaining), count));
+            hash = _mm256_add_epi32(hash, _mm256_i32gather_epi32(hashTable, index, 4));
+            remaining = _mm256_sub_epi32(remaining, count);
+        }
+        __m256i value = _mm256_and_si256(_mm256_i32gather_epi32(noFlushValues, hash, 2), lowHalf);
+
+        value = _mm256_blendv_epi8(value, flushValue, hasFlush);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(values + h), value);
+    }
+
+    // The last few hands one at a time
+    const uint8_t* rest[7];
+    for (int i = 0; i < 7; ++i) {
+        rest[i] = cards[i] + h;
+    }
+    evaluateBatchScalar(rest, numHands - h, values + h);
+}
+
+#else
+
+bool HandEvaluator::usesAvx2() {
+    return false;
+}
+
+void HandEvaluator::evaluateBatchAvx2(const uint8_t* const cards[7], int numHands, int values[]) const {
+    evaluateBatchScalar(cards, numHands, values);
+}
+
+#endif
+
+} // namespace poker
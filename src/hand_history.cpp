@@ -0,0 +1,177 @@
+#include "poker/hand_history.h"
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <stdexcept>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define POKER_HAVE_MMAP 1
+#endif
+
+using namespace std;
+
+namespace poker {
+
+HandHistoryWriter::HandHistoryWriter(const string& path) : path(path), file(nullptr), buffer(1 << 20), hands(0) {
+    HandHistoryHeader header = {};
+    bool isNew = true;
+    if (FILE* existing = fopen(path.c_str(), "rb")) {
+        size_t bytes = fread(&header, 1, sizeof(header), existing);
+        fclose(existing);
+        if (bytes > 0) {
+            if (bytes != sizeof(header) || memcmp(header.magic, HAND_HISTORY_MAGIC, 4) != 0 ||
+                header.version != HAND_HISTORY_VERSION) {
+                throw runtime_error(path + " is not a version " + to_string(HAND_HISTORY_VERSION) + " hand history.");
+            }
+            isNew = false;
+        }
+    }
+
+    // A writer that was interrupted can leave half a hand at the end; appending after it would
+    // hide every later hand from readers, so cut the file back to the last complete hand
+    if (!isNew) {
+        size_t complete;
+        {
+            HandHistoryReader reader(path);
+            HandHistoryReader::Hand hand;
+            while (reader.next(hand)) {}
+            complete = reader.position();
+        }
+        error_code error;
+        if (filesystem::file_size(path) != complete) {
+            filesystem::resize_file(path, complete, error);
+            if (error) {
+                throw runtime_error("Cannot cut the unfinished hand off " + path + ": " + error.message());
+            }
+        }
+    }
+
+    file = fopen(path.c_str(), "ab");
+    if (!file) {
+        throw runtime_error("Cannot open " + path + " for writing.");
+    }
+    setvbuf(file, buffer.data(), _IOFBF, buffer.size());
+    if (isNew) {
+        memcpy(header.magic, HAND_HISTORY_MAGIC, 4);
+        header.version = HAND_HISTORY_VERSION;
+        header.recordAlignment = alignof(ActionRecord);
+        header.reserved = 0;
+        if (fwrite(&header, sizeof(header), 1, file) != 1) {
+            fclose(file);
+            throw runtime_error("Cannot write to " + path + ".");
+        }
+    }
+}
+
+HandHistoryWriter::~HandHistoryWriter() {
+    if (file && fclose(file) != 0) {
+        cerr << "Hands may have been lost: cannot finish writing " << path << "." << endl;
+    }
+}
+
+void HandHistoryWriter::close() {
+    lock_guard<mutex> guard(lock);
+    if (!file) return;
+    int closed = fclose(file);
+    file = nullptr;
+    if (closed != 0) {
+        throw runtime_error("Cannot finish writing " + path + "; the last hands may be lost.");
+    }
+}
+
+void HandHistoryWriter::writeHand(HandRecord hand, const ActionLog& actionLog) {
+    if (actionLog.size() > UINT16_MAX) {
+        throw runtime_error("Hand " + to_string(hand.handNumber) + " has too many actions to record.");
+    }
+    hand.numActions = static_cast<uint16_t>(actionLog.size());
+    hand.size = static_cast<uint32_t>(sizeof(HandRecord) + actionLog.size() * sizeof(ActionRecord));
+
+    lock_guard<mutex> guard(lock);
+    bool written = file && fwrite(&hand, sizeof(hand), 1, file) == 1;
+    for (int i = 0; written && i < actionLog.size(); ++i) {
+        written = fwrite(&actionLog[i], sizeof(ActionRecord), 1, file) == 1;
+    }
+    if (!written) {
+        throw runtime_error("Cannot write hand " + to_string(hand.handNumber) + " to " + path + ".");
+    }
+    hands++;
+}
+
+HandHistoryReader::HandHistoryReader(const string& path) : data(nullptr), length(0), offset(sizeof(HandHistoryHeader)), mapped(false) {
+#ifdef POKER_HAVE_MMAP
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw runtime_error("Cannot open " + path + ".");
+    }
+    struct stat info;
+    if (fstat(fd, &info) == 0 && info.st_size > 0) {
+        length = static_cast<size_t>(info.st_size);
+        void* address = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (address != MAP_FAILED) {
+            data = static_cast<const char*>(address);
+            mapped = true;
+            madvise(address, length, MADV_SEQUENTIAL);
+        }
+    }
+    close(fd);
+#endif
+    if (!mapped) {
+        ifstream in(path, ios::binary);
+        if (!in) {
+            throw runtime_error("Cannot open " + path + ".");
+        }
+        contents.assign(istreambuf_iterator<char>(in), istreambuf_iterator<char>());
+        data = contents.data();
+        length = contents.size();
+    }
+
+    const HandHistoryHeader* header = reinterpret_cast<const HandHistoryHeader*>(data);
+    if (length < sizeof(HandHistoryHeader) || memcmp(header->magic, HAND_HISTORY_MAGIC, 4) != 0) {
+        release();
+        throw runtime_error(path + " is not a hand history.");
+    }
+    if (header->version != HAND_HISTORY_VERSION) {
+        release();
+        throw runtime_error(path + " has unsupported hand history version " + to_string(header->version) + ".");
+    }
+}
+
+HandHistoryReader::~HandHistoryReader() {
+    release();
+}
+
+bool HandHistoryReader::next(Hand& hand) {
+    if (length - offset < sizeof(HandRecord)) {
+        return false;
+    }
+    const HandRecord* record = reinterpret_cast<const HandRecord*>(data + offset);
+    if (record->size != sizeof(HandRecord) + record->numActions * sizeof(ActionRecord) ||
+        record->numSeats > MAX_PLAYERS || record->boardSize > 5) {
+        throw runtime_error("Corrupt hand record at byte " + to_string(offset) + ".");
+    }
+    if (length - offset < record->size) {
+        return false;
+    }
+    hand.record = record;
+    hand.actions = reinterpret_cast<const ActionRecord*>(data + offset + sizeof(HandRecord));
+    offset += record->size;
+    return true;
+}
+
+void HandHistoryReader::release() {
+#ifdef POKER_HAVE_MMAP
+    if (mapped) {
+        munmap(const_cast<char*>(data), length);
+        mapped = false;
+    }
+#endif
+}
+
+} // namespace poker
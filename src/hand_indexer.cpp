@@ -0,0 +1,301 @@
+#include "poker/hand_indexer.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+using namespace std;
+
+namespace poker {
+
+namespace {
+
+const int NUM_RANKS = 13;
+const int BITS_PER_ROUND = 3;
+
+// Struct for the binomial coefficients C(n, k) of up to 13 ranks
+struct BinomialTable {
+    uint32_t values[NUM_RANKS + 1][NUM_RANKS + 1];
+
+    constexpr BinomialTable() : values() {
+        for (int n = 0; n <= NUM_RANKS; ++n) {
+            values[n][0] = 1;
+            for (int k = 1; k <= n; ++k) {
+                values[n][k] = values[n - 1][k - 1] + (k < n ? values[n - 1][k] : 0);
+            }
+        }
+    }
+};
+
+constexpr BinomialTable BINOMIALS;
+
+// Returns C(n, k) for the small k of a group of suits, 0 when k > n
+uint64_t binomial(uint64_t n, int k) {
+    if (static_cast<uint64_t>(k) > n) return 0;
+    uint64_t result = 1;
+    for (int i = 0; i < k; ++i) {
+        result = result * (n - i) / (i + 1);
+    }
+    return result;
+}
+
+// Returns the number of ways count interchangeable suits can each take one of n numbers
+uint64_t multisets(uint64_t n, int count) {
+    return binomial(n + count - 1, count);
+}
+
+// Returns the cards a suit gets in a round, from its packed configuration
+int roundCount(uint16_t suit, int round) {
+    return (suit >> (BITS_PER_ROUND * (HandIndexer::MAX_ROUNDS - 1 - round))) & 7;
+}
+
+// Function to list the suit configurations of a deal, each sorted largest suit first
+//
+// Picks the configuration of one suit at a time, never larger than the suit before it, from the
+// cards left to deal in every round; the last suit takes whatever is left.
+//
+// Parameters:
+// - int round: The last round dealt.
+// - int slot: The suit being picked, 0 to 3.
+// - int remaining[]: The cards still to deal in each round.
+// - uint16_t previous: The configuration of the previous suit.
+// - uint64_t key: The configurations picked so far, packed.
+// - vector<uint64_t>& keys: Receives the packed configurations.
+void collectKeys(int round, int slot, int remaining[], uint16_t previous, uint64_t key, vector<uint64_t>& keys) {
+    int counts[HandIndexer::MAX_ROUNDS] = {};
+    if (slot == 3) {
+        copy(remaining, remaining + round + 1, counts);
+    }
+    while (true) {
+        uint16_t suit = 0;
+        int total = 0;
+        for (int r = 0; r <= round; ++r) {
+            suit |= static_cast<uint16_t>(counts[r] << (BITS_PER_ROUND * (HandIndexer::MAX_ROUNDS - 1 - r)));
+            total += counts[r];
+        }
+        if (suit <= previous && total <= NUM_RANKS) {
+            uint64_t next = key | static_cast<uint64_t>(suit) << (12 * (3 - slot));
+            if (slot == 3) {
+                keys.push_back(next);
+            }
+            else {
+                for (int r = 0; r <= round; ++r) remaining[r] -= counts[r];
+                collectKeys(round, slot + 1, remaining, suit, next, keys);
+                for (int r = 0; r <= round; ++r) remaining[r] += counts[r];
+            }
+        }
+        if (slot == 3) return;
+
+        // Next configuration for this suit, counting up round by round
+        int r = 0;
+        while (r <= round && ++counts[r] > remaining[r]) {
+            counts[r] = 0;
+            ++r;
+        }
+        if (r > round) return;
+    }
+}
+
+} // namespace
+
+HandIndexer::HandIndexer(const int cardsPerRound[], int numRounds) : numRounds(numRounds), cardsPerRound(), roundStart(), sizes() {
+    if (numRounds < 1 || numRounds > MAX_ROUNDS) {
+        throw invalid_argument("A hand indexer needs 1 to " + to_string(MAX_ROUNDS) + " rounds.");
+    }
+    for (int r = 0; r < numRounds; ++r) {
+        if (cardsPerRound[r] < 1 || cardsPerRound[r] > MAX_CARDS_PER_ROUND) {
+            throw invalid_argument("A round needs 1 to " + to_string(MAX_CARDS_PER_ROUND) + " cards.");
+        }
+        this->cardsPerRound[r] = cardsPerRound[r];
+        roundStart[r + 1] = roundStart[r] + cardsPerRound[r];
+    }
+    for (int r = 0; r < numRounds; ++r) {
+        addConfigurations(r);
+    }
+}
+
+const HandIndexer& HandIndexer::holdem(Street street) {
+    static const int STREET_ROUNDS[4][2] = { { 2, 0 }, { 2, 3 }, { 2, 4 }, { 2, 5 } };
+    static const HandIndexer indexers[4] = {
+        HandIndexer(STREET_ROUNDS[PREFLOP], 1),
+        HandIndexer(STREET_ROUNDS[FLOP], 2),
+        HandIndexer(STREET_ROUNDS[TURN], 2),
+        HandIndexer(STREET_ROUNDS[RIVER], 2),
+    };
+    return indexers[street];
+}
+
+uint64_t HandIndexer::suitSize(uint16_t suit, int round) const {
+    uint64_t size = 1;
+    int used = 0;
+    for (int r = 0; r <= round; ++r) {
+        int count = roundCount(suit, r);
+        size *= BINOMIALS.values[NUM_RANKS - used][count];
+        used += count;
+    }
+    return size;
+}
+
+void HandIndexer::addConfigurations(int round) {
+    int remaining[MAX_ROUNDS] = {};
+    copy(cardsPerRound, cardsPerRound + round + 1, remaining);
+    vector<uint64_t> keys;
+    collectKeys(round, 0, remaining, 0xFFFF, 0, keys);
+    sort(keys.begin(), keys.end());
+
+    uint64_t offset = 0;
+    for (uint64_t key : keys) {
+        Configuration configuration;
+        configuration.key = key;
+        configuration.offset = offset;
+        for (int slot = 0; slot < 4; ++slot) {
+            configuration.suits[slot] = static_cast<uint16_t>((key >> (12 * (3 - slot))) & 0xFFF);
+            configuration.suitSizes[slot] = suitSize(configuration.suits[slot], round);
+        }
+
+        // Suits with the same configuration take their numbers as a multiset
+        uint64_t size = 1;
+        for (int i = 0; i < 4;) {
+            int j = i + 1;
+            while (j < 4 && configuration.suits[j] == configuration.suits[i]) ++j;
+            size *= multisets(configuration.suitSizes[i], j - i);
+            i = j;
+        }
+        configurations[round].push_back(configuration);
+        offset += size;
+    }
+    sizes[round] = offset;
+}
+
+uint64_t HandIndexer::index(const Card cards[], int round) const {
+    // Number each suit's ranks round by round, as a combination of the ranks it has left
+    uint16_t suits[4] = {};
+    uint64_t suitIndices[4] = {};
+    uint64_t multipliers[4] = { 1, 1, 1, 1 };
+    uint32_t used[4] = {};
+    for (int r = 0; r <= round; ++r) {
+        uint32_t dealt[4] = {};
+        for (int i = roundStart[r]; i < roundStart[r + 1]; ++i) {
+            if (cards[i].empty()) {
+                throw invalid_argument("Cannot index a hand with a missing or repeated card.");
+            }
+            uint32_t bit = 1u << cards[i].rankIndex();
+            int suit = cards[i].suitIndex();
+            if (((used[suit] | dealt[suit]) & bit) != 0) {
+                throw invalid_argument("Cannot index a hand with a missing or repeated card.");
+            }
+            dealt[suit] |= bit;
+        }
+        for (int suit = 0; suit < 4; ++suit) {
+            uint64_t combination = 0;
+            int position = 0;
+            int chosen = 0;
+            for (int rank = 0; rank < NUM_RANKS; ++rank) {
+                if ((used[suit] >> rank) & 1) continue;
+                if ((dealt[suit] >> rank) & 1) {
+                    combination += BINOMIALS.values[position][++chosen];
+                }
+                ++position;
+            }
+            suitIndices[suit] += multipliers[suit] * combination;
+            multipliers[suit] *= BINOMIALS.values[position][chosen];
+            suits[suit] |= static_cast<uint16_t>(chosen << (BITS_PER_ROUND * (MAX_ROUNDS - 1 - r)));
+            used[suit] |= dealt[suit];
+        }
+    }
+
+    // Largest configuration first; suits that tie are ordered by their numbers
+    for (int i = 1; i < 4; ++i) {
+        for (int j = i; j > 0 && (suits[j] > suits[j - 1] || (suits[j] == suits[j - 1] && suitIndices[j] < suitIndices[j - 1])); --j) {
+            swap(suits[j], suits[j - 1]);
+            swap(suitIndices[j], suitIndices[j - 1]);
+        }
+    }
+    uint64_t key = static_cast<uint64_t>(suits[0]) << 36 | static_cast<uint64_t>(suits[1]) << 24 |
+                   static_cast<uint64_t>(suits[2]) << 12 | suits[3];
+    const vector<Configuration>& list = configurations[round];
+    auto found = lower_bound(list.begin(), list.end(), key,
+                             [](const Configuration& configuration, uint64_t value) { return configuration.key < value; });
+    const Configuration& configuration = *found;
+
+    uint64_t index = 0;
+    uint64_t multiplier = 1;
+    for (int i = 0; i < 4;) {
+        int j = i + 1;
+        while (j < 4 && suits[j] == suits[i]) ++j;
+        uint64_t multiset = 0;
+        for (int k = i; k < j; ++k) {
+            multiset += binomial(suitIndices[k] + (k - i), k - i + 1);
+        }
+        index += multiplier * multiset;
+        multiplier *= multisets(configuration.suitSizes[i], j - i);
+        i = j;
+    }
+    return configuration.offset + index;
+}
+
+void HandIndexer::unindex(int round, uint64_t index, Card cards[]) const {
+    if (index >= sizes[round]) {
+        throw invalid_argument("Hand index " + to_string(index) + " is out of range.");
+    }
+    const vector<Configuration>& list = configurations[round];
+    auto found = upper_bound(list.begin(), list.end(), index,
+                             [](uint64_t value, const Configuration& configuration) { return value < configuration.offset; });
+    const Configuration& configuration = *(found - 1);
+    uint64_t remainder = index - configuration.offset;
+
+    // Split the index into each group's multiset, then the multiset into the suits' numbers
+    uint64_t suitIndices[4] = {};
+    for (int i = 0; i < 4;) {
+        int j = i + 1;
+        while (j < 4 && configuration.suits[j] == configuration.suits[i]) ++j;
+        uint64_t count = multisets(configuration.suitSizes[i], j - i);
+        uint64_t multiset = remainder % count;
+        remainder /= count;
+        for (int k = j - i - 1; k >= 0; --k) {
+            // Largest b with C(b, k + 1) <= multiset
+            uint64_t low = k;
+            uint64_t high = configuration.suitSizes[i] - 1 + k;
+            while (low < high) {
+                uint64_t middle = (low + high + 1) / 2;
+                if (binomial(middle, k + 1) <= multiset) low = middle;
+                else high = middle - 1;
+            }
+            multiset -= binomial(low, k + 1);
+            suitIndices[i + k] = low - k;
+        }
+        i = j;
+    }
+
+    // Deal each suit the ranks its number stands for
+    int filled[MAX_ROUNDS] = {};
+    for (int suit = 0; suit < 4; ++suit) {
+        uint64_t value = suitIndices[suit];
+        uint32_t used = 0;
+        int numUsed = 0;
+        for (int r = 0; r <= round; ++r) {
+            int count = roundCount(configuration.suits[suit], r);
+            int free = NUM_RANKS - numUsed;
+            uint32_t combination = static_cast<uint32_t>(value % BINOMIALS.values[free][count]);
+            value /= BINOMIALS.values[free][count];
+
+            uint32_t dealt = 0;
+            for (int k = count; k >= 1; --k) {
+                int position = k - 1;
+                while (position + 1 < free && BINOMIALS.values[position + 1][k] <= combination) ++position;
+                combination -= BINOMIALS.values[position][k];
+
+                // The position-th rank the suit has not used in earlier rounds
+                int rank = 0;
+                for (int seen = -1;; ++rank) {
+                    if (((used >> rank) & 1) == 0 && ++seen == position) break;
+                }
+                dealt |= 1u << rank;
+                cards[roundStart[r] + filled[r]++] = Card(rank * 4 + suit);
+            }
+            used |= dealt;
+            numUsed += count;
+        }
+    }
+}
+
+} // namespace poker
@@ -0,0 +1,32 @@
+#include "poker/inter_graph.h"
+
+#include <iostream>
+
+using namespace std;
+
+namespace poker {
+
+void InterGraph::display() const {
+    cout << "\nPlayer Interactions:\n";
+    for (int i = 0; i < MAX_PLAYERS; ++i) {
+        for (int j = i + 1; j < MAX_PLAYERS; ++j) {
+            const Interaction& edge = edges[i][j];
+            if (edge.hands == 0 && edge.count == 0) continue;
+            cout << "  - " << names[i] << " and " << names[j] << ": " << edge.hands << " hands, " << edge.count
+                 << " betting rounds (Chips: " << edge.chips << "), " << names[i] << (edge.net < 0 ? " lost " : " won ")
+                 << (edge.net < 0 ? -edge.net : edge.net) << ", showdowns won " << edge.showdownWins << "-"
+                 << edges[j][i].showdownWins << ", last in hand " << edge.lastHand << "\n";
+        }
+    }
+}
+
+void InterGraph::reset() {
+    for (int i = 0; i < MAX_PLAYERS; ++i) {
+        names[i].clear();
+        for (int j = 0; j < MAX_PLAYERS; ++j) {
+            edges[i][j] = Interaction();
+        }
+    }
+}
+
+} // namespace poker
@@ -0,0 +1,482 @@
+#include "poker/interaction_store.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+
+#include "poker/file_io.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define POKER_HAVE_MMAP 1
+#endif
+
+using namespace std;
+namespace fs = std::filesystem;
+
+namespace poker {
+
+namespace {
+
+const char NAMES_FILE[] = "names";
+const char NAMES_MAGIC[4] = { 'P', 'K', 'I', 'N' };
+const char SEGMENT_PREFIX[] = "segment-";
+const char SEGMENT_SUFFIX[] = ".pkis";
+
+// A row as it is built in memory: player << 32 | rival, and the totals
+typedef pair<uint64_t, InteractionTotals> Row;
+
+void addTotals(InteractionTotals& totals, const InteractionTotals& more) {
+    totals.hands += more.hands;
+    totals.rounds += more.rounds;
+    totals.chips += more.chips;
+    totals.net += more.net;
+    totals.showdowns += more.showdowns;
+    totals.showdownWins += more.showdownWins;
+}
+
+string segmentName(uint64_t number) {
+    char name[32];
+    snprintf(name, sizeof(name), "%s%08llu%s", SEGMENT_PREFIX, static_cast<unsigned long long>(number), SEGMENT_SUFFIX);
+    return name;
+}
+
+// Returns the number of a segment file name, or false if it is not one
+bool parseSegmentName(const string& name, uint64_t& number) {
+    size_t prefix = strlen(SEGMENT_PREFIX);
+    size_t suffix = strlen(SEGMENT_SUFFIX);
+    if (name.size() <= prefix + suffix || name.compare(0, prefix, SEGMENT_PREFIX) != 0 ||
+        name.compare(name.size() - suffix, suffix, SEGMENT_SUFFIX) != 0) {
+        return false;
+    }
+    string digits = name.substr(prefix, name.size() - prefix - suffix);
+    if (digits.find_first_not_of("0123456789") != string::npos) return false;
+    number = stoull(digits);
+    return true;
+}
+
+} // namespace
+
+// Struct for a segment file, mapped into memory, and its columns
+struct InteractionStore::Segment {
+    string path;
+    uint64_t number;
+    const char* data = nullptr;
+    size_t length = 0;
+    bool mapped = false;
+    vector<char> contents; // Holds the file when it could not be mapped
+    const InteractionSegmentHeader* header = nullptr;
+    const uint32_t* player = nullptr;
+    const uint32_t* rival = nullptr;
+    const uint64_t* counts[4] = {}; // hands, rounds, showdowns, showdownWins
+    const int64_t* sums[2] = {};    // chips, net
+
+    Segment(const string& segmentPath, uint64_t segmentNumber) : path(segmentPath), number(segmentNumber) {
+#ifdef POKER_HAVE_MMAP
+        int fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            throw runtime_error("Cannot open " + path + ".");
+        }
+        struct stat info;
+        if (fstat(fd, &info) == 0 && info.st_size > 0) {
+            length = static_cast<size_t>(info.st_size);
+            void* address = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (address != MAP_FAILED) {
+                data = static_cast<const char*>(address);
+                mapped = true;
+            }
+        }
+        close(fd);
+#endif
+        if (!mapped) {
+            ifstream in(path, ios::binary);
+            if (!in) {
+                throw runtime_error("Cannot open " + path + ".");
+            }
+            contents.assign(istreambuf_iterator<char>(in), istreambuf_iterator<char>());
+            data = contents.data();
+            length = contents.size();
+        }
+
+        header = reinterpret_cast<const InteractionSegmentHeader*>(data);
+        if (length < sizeof(InteractionSegmentHeader) || memcmp(header->magic, INTERACTION_SEGMENT_MAGIC, 4) != 0 ||
+            header->version != INTERACTION_SEGMENT_VERSION ||
+            length != sizeof(InteractionSegmentHeader) + header->numRows * (2 * sizeof(uint32_t) + 6 * sizeof(uint64_t)) ||
+            header->firstHand > header->lastHand) {
+            release();
+            throw runtime_error(path + " is not a version " + to_string(INTERACTION_SEGMENT_VERSION) + " interaction segment.");
+        }
+        size_t rows = header->numRows;
+        player = reinterpret_cast<const uint32_t*>(data + sizeof(InteractionSegmentHeader));
+        rival = player + rows;
+        const uint64_t* column = reinterpret_cast<const uint64_t*>(rival + rows);
+        for (int i = 0; i < 4; ++i, column += rows) counts[i] = column;
+        for (int i = 0; i < 2; ++i, column += rows) sums[i] = reinterpret_cast<const int64_t*>(column);
+    }
+
+    ~Segment() {
+        release();
+    }
+
+    void release() {
+#ifdef POKER_HAVE_MMAP
+        if (mapped) {
+            munmap(const_cast<char*>(data), length);
+            mapped = false;
+        }
+#endif
+    }
+
+    size_t rows() const {
+        return header->numRows;
+    }
+
+    uint64_t key(size_t row) const {
+        return static_cast<uint64_t>(player[row]) << 32 | rival[row];
+    }
+
+    void addRow(size_t row, InteractionTotals& totals) const {
+        totals.hands += counts[0][row];
+        totals.rounds += counts[1][row];
+        totals.showdowns += counts[2][row];
+        totals.showdownWins += counts[3][row];
+        totals.chips += sums[0][row];
+        totals.net += sums[1][row];
+    }
+
+    // Returns the rows of a player as [first, last)
+    pair<size_t, size_t> rowsOf(uint32_t id) const {
+        auto range = equal_range(player, player + rows(), id);
+        return { static_cast<size_t>(range.first - player), static_cast<size_t>(range.second - player) };
+    }
+};
+
+InteractionStore::InteractionStore(const string& directory) : directory(directory), namesSaved(0), nextFile(1) {
+    error_code error;
+    fs::create_directories(directory, error);
+    if (!fs::is_directory(directory)) {
+        throw runtime_error("Cannot create the interaction store " + directory + ".");
+    }
+
+    // Each name is a uint32_t length and then its bytes, so names may hold any character
+    fs::path namesPath = fs::path(directory) / NAMES_FILE;
+    ifstream namesFile(namesPath, ios::binary);
+    if (namesFile) {
+        vector<char> contents((istreambuf_iterator<char>(namesFile)), istreambuf_iterator<char>());
+        if (!contents.empty() && (contents.size() < sizeof(NAMES_MAGIC) || memcmp(contents.data(), NAMES_MAGIC, 4) != 0)) {
+            throw runtime_error(namesPath.string() + " is not an interaction store name dictionary.");
+        }
+        size_t offset = contents.empty() ? 0 : sizeof(NAMES_MAGIC);
+        while (offset < contents.size()) {
+            uint32_t length;
+            if (contents.size() - offset < sizeof(length)) {
+                throw runtime_error(namesPath.string() + " is damaged (name length cut short).");
+            }
+            memcpy(&length, contents.data() + offset, sizeof(length));
+            offset += sizeof(length);
+            if (length > contents.size() - offset) {
+                throw runtime_error(namesPath.string() + " is damaged (name longer than the file).");
+            }
+            string name(contents.data() + offset, length);
+            offset += length;
+            nameIds.emplace(name, static_cast<uint32_t>(names.size()));
+            names.push_back(move(name));
+        }
+    }
+    namesSaved = names.size();
+    openSegments();
+}
+
+InteractionStore::~InteractionStore() {}
+
+void InteractionStore::openSegments() {
+    vector<unique_ptr<Segment>> found;
+    for (const fs::directory_entry& entry : fs::directory_iterator(directory)) {
+        string name = entry.path().filename().string();
+        uint64_t number;
+        if (name.size() > 4 && name.compare(name.size() - 4, 4, ".tmp") == 0) {
+            fs::remove(entry.path()); // Left by a writer that was interrupted
+        }
+        else if (parseSegmentName(name, number)) {
+            found.emplace_back(new Segment(entry.path().string(), number));
+            nextFile = max(nextFile, number + 1);
+            // Rows come in both orders, so the last row's player is the largest number used
+            const Segment& segment = *found.back();
+            if (segment.rows() > 0 && segment.player[segment.rows() - 1] >= names.size()) {
+                throw runtime_error(segment.path + " uses a player missing from the name dictionary.");
+            }
+        }
+    }
+
+    // Oldest hands first; a segment inside another is left over from an interrupted merge
+    sort(found.begin(), found.end(), [](const unique_ptr<Segment>& a, const unique_ptr<Segment>& b) {
+        if (a->header->firstHand != b->header->firstHand) return a->header->firstHand < b->header->firstHand;
+        return a->header->lastHand > b->header->lastHand;
+    });
+    for (unique_ptr<Segment>& segment : found) {
+        if (!segmentFiles.empty() && segment->header->firstHand <= segmentFiles.back()->header->lastHand) {
+            if (segment->header->lastHand > segmentFiles.back()->header->lastHand) {
+                throw runtime_error(segment->path + " overlaps " + segmentFiles.back()->path + ".");
+            }
+            string path = segment->path;
+            segment.reset();
+            fs::remove(path);
+            continue;
+        }
+        segmentFiles.push_back(move(segment));
+    }
+}
+
+uint32_t InteractionStore::nameId(const string& name) {
+    auto found = nameIds.find(name);
+    if (found != nameIds.end()) {
+        return found->second;
+    }
+    uint32_t id = static_cast<uint32_t>(names.size());
+    nameIds.emplace(name, id);
+    names.push_back(name);
+    return id;
+}
+
+void InteractionStore::saveNames() {
+    if (namesSaved == names.size()) return;
+    vector<char> dictionary(NAMES_MAGIC, NAMES_MAGIC + sizeof(NAMES_MAGIC));
+    for (const string& name : names) {
+        uint32_t length = static_cast<uint32_t>(name.size());
+        const char* bytes = reinterpret_cast<const char*>(&length);
+        dictionary.insert(dictionary.end(), bytes, bytes + sizeof(length));
+        dictionary.insert(dictionary.end(), name.begin(), name.end());
+    }
+    writeFileAtomically((fs::path(directory) / NAMES_FILE).string(), { { dictionary.data(), dictionary.size() } });
+    namesSaved = names.size();
+}
+
+bool InteractionStore::findName(const string& name, uint32_t& id) const {
+    auto found = nameIds.find(name);
+    if (found == nameIds.end()) return false;
+    id = found->second;
+    return true;
+}
+
+unique_ptr<InteractionStore::Segment> InteractionStore::writeSegment(const InteractionSegmentHeader& header,
+                                                                     const vector<Row>& rows) {
+    string path = (fs::path(directory) / segmentName(nextFile)).string();
+
+    // One column at a time, in the order of InteractionSegmentHeader
+    size_t numRows = rows.size();
+    vector<uint32_t> ids(2 * numRows);
+    vector<uint64_t> values(6 * numRows);
+    for (size_t r = 0; r < numRows; ++r) {
+        const InteractionTotals& totals = rows[r].second;
+        ids[r] = static_cast<uint32_t>(rows[r].first >> 32);
+        ids[numRows + r] = static_cast<uint32_t>(rows[r].first);
+        values[r] = totals.hands;
+        values[numRows + r] = totals.rounds;
+        values[2 * numRows + r] = totals.showdowns;
+        values[3 * numRows + r] = totals.showdownWins;
+        values[4 * numRows + r] = static_cast<uint64_t>(totals.chips);
+        values[5 * numRows + r] = static_cast<uint64_t>(totals.net);
+    }
+
+    // Every name a row uses is on disk before the segment is
+    saveNames();
+    writeFileAtomically(path, { { &header, sizeof(header) },
+                                { ids.data(), ids.size() * sizeof(uint32_t) },
+                                { values.data(), values.size() * sizeof(uint64_t) } });
+    return unique_ptr<Segment>(new Segment(path, nextFile++));
+}
+
+void InteractionStore::append(const InterGraph& graph, long long sessionHands) {
+    if (sessionHands <= 0) return;
+
+    lock_guard<mutex> guard(lock);
+    uint32_t ids[MAX_PLAYERS];
+    bool named[MAX_PLAYERS] = {};
+    for (int i = 0; i < MAX_PLAYERS; ++i) {
+        named[i] = !graph.name(i).empty();
+        if (named[i]) ids[i] = nameId(graph.name(i));
+    }
+
+    vector<Row> rows;
+    for (int i = 0; i < MAX_PLAYERS; ++i) {
+        for (int j = 0; j < MAX_PLAYERS; ++j) {
+            const Interaction& edge = graph.between(i, j);
+            if (!named[i] || !named[j] || ids[i] == ids[j] || (edge.hands == 0 && edge.count == 0)) continue;
+            InteractionTotals totals;
+            totals.hands = static_cast<uint64_t>(edge.hands);
+            totals.rounds = static_cast<uint64_t>(edge.count);
+            totals.chips = edge.chips;
+            totals.net = edge.net;
+            totals.showdowns = static_cast<uint64_t>(edge.showdowns);
+            totals.showdownWins = static_cast<uint64_t>(edge.showdownWins);
+            rows.push_back({ static_cast<uint64_t>(ids[i]) << 32 | ids[j], totals });
+        }
+    }
+
+    // Players sharing a name are the same player to the store
+    sort(rows.begin(), rows.end(), [](const Row& a, const Row& b) { return a.first < b.first; });
+    size_t kept = 0;
+    for (size_t r = 0; r < rows.size(); ++r) {
+        if (kept > 0 && rows[kept - 1].first == rows[r].first) addTotals(rows[kept - 1].second, rows[r].second);
+        else rows[kept++] = rows[r];
+    }
+    rows.resize(kept);
+
+    InteractionSegmentHeader header = {};
+    memcpy(header.magic, INTERACTION_SEGMENT_MAGIC, 4);
+    header.version = INTERACTION_SEGMENT_VERSION;
+    header.numRows = rows.size();
+    header.firstHand = (segmentFiles.empty() ? 0 : segmentFiles.back()->header->lastHand) + 1;
+    header.lastHand = header.firstHand + static_cast<uint64_t>(sessionHands) - 1;
+    header.sessions = 1;
+    segmentFiles.push_back(writeSegment(header, rows));
+
+    // Merge the neighbours covering the fewest hands until there are few enough segments
+    while (segmentFiles.size() > static_cast<size_t>(MAX_SEGMENTS)) {
+        size_t best = 0;
+        uint64_t bestHands = UINT64_MAX;
+        for (size_t i = 0; i + 1 < segmentFiles.size(); ++i) {
+            uint64_t spanned = segmentFiles[i + 1]->header->lastHand - segmentFiles[i]->header->firstHand;
+            if (spanned < bestHands) {
+                best = i;
+                bestHands = spanned;
+            }
+        }
+        merge(best, best + 1);
+    }
+}
+
+void InteractionStore::merge(size_t first, size_t last) {
+    // Every segment is sorted by key, so step through them together taking the smallest key each time
+    vector<size_t> cursors(last - first + 1, 0);
+    vector<Row> rows;
+    InteractionSegmentHeader header = {};
+    memcpy(header.magic, INTERACTION_SEGMENT_MAGIC, 4);
+    header.version = INTERACTION_SEGMENT_VERSION;
+    header.firstHand = segmentFiles[first]->header->firstHand;
+    header.lastHand = segmentFiles[last]->header->lastHand;
+    for (size_t s = first; s <= last; ++s) {
+        header.sessions += segmentFiles[s]->header->sessions;
+    }
+    while (true) {
+        uint64_t key = UINT64_MAX;
+        bool any = false;
+        for (size_t s = first; s <= last; ++s) {
+            const Segment& segment = *segmentFiles[s];
+            if (cursors[s - first] < segment.rows()) {
+                key = min(key, segment.key(cursors[s - first]));
+                any = true;
+            }
+        }
+        if (!any) break;
+        Row row = { key, InteractionTotals() };
+        for (size_t s = first; s <= last; ++s) {
+            const Segment& segment = *segmentFiles[s];
+            size_t& cursor = cursors[s - first];
+            if (cursor < segment.rows() && segment.key(cursor) == key) segment.addRow(cursor++, row.second);
+        }
+        rows.push_back(row);
+    }
+    header.numRows = rows.size();
+
+    // The merged segment is in place before the ones it replaces go; if they outlive an
+    // interruption, openSegments() drops them as covered by it
+    unique_ptr<Segment> merged = writeSegment(header, rows);
+    for (size_t s = first; s <= last; ++s) {
+        string path = segmentFiles[s]->path;
+        segmentFiles[s].reset();
+        fs::remove(path);
+    }
+    segmentFiles.erase(segmentFiles.begin() + static_cast<ptrdiff_t>(first) + 1,
+                       segmentFiles.begin() + static_cast<ptrdiff_t>(last) + 1);
+    segmentFiles[first] = move(merged);
+}
+
+void InteractionStore::compact() {
+    lock_guard<mutex> guard(lock);
+    if (segmentFiles.size() > 1) {
+        merge(0, segmentFiles.size() - 1);
+    }
+}
+
+size_t InteractionStore::firstInWindow(long long lastHands) const {
+    if (lastHands <= 0 || segmentFiles.empty()) return 0;
+    uint64_t total = segmentFiles.back()->header->lastHand;
+    if (static_cast<uint64_t>(lastHands) >= total) return 0;
+    uint64_t newest = total - static_cast<uint64_t>(lastHands); // Hands up to this one are outside the window
+    auto found = upper_bound(segmentFiles.begin(), segmentFiles.end(), newest,
+                             [](uint64_t hand, const unique_ptr<Segment>& segment) { return hand < segment->header->lastHand; });
+    return static_cast<size_t>(found - segmentFiles.begin());
+}
+
+InteractionTotals InteractionStore::between(const string& player, const string& rival, long long lastHands) const {
+    lock_guard<mutex> guard(lock);
+    InteractionTotals totals;
+    uint32_t playerId, rivalId;
+    if (!findName(player, playerId) || !findName(rival, rivalId)) {
+        return totals;
+    }
+    for (size_t s = firstInWindow(lastHands); s < segmentFiles.size(); ++s) {
+        const Segment& segment = *segmentFiles[s];
+        pair<size_t, size_t> rows = segment.rowsOf(playerId);
+        const uint32_t* found = lower_bound(segment.rival + rows.first, segment.rival + rows.second, rivalId);
+        if (found != segment.rival + rows.second && *found == rivalId) {
+            segment.addRow(static_cast<size_t>(found - segment.rival), totals);
+        }
+    }
+    return totals;
+}
+
+vector<InteractionStore::Rival> InteractionStore::topRivals(const string& player, int count, long long lastHands) const {
+    lock_guard<mutex> guard(lock);
+    vector<Rival> rivals;
+    uint32_t playerId;
+    if (!findName(player, playerId) || count <= 0) {
+        return rivals;
+    }
+
+    unordered_map<uint32_t, InteractionTotals> totals;
+    for (size_t s = firstInWindow(lastHands); s < segmentFiles.size(); ++s) {
+        const Segment& segment = *segmentFiles[s];
+        pair<size_t, size_t> rows = segment.rowsOf(playerId);
+        for (size_t row = rows.first; row < rows.second; ++row) {
+            segment.addRow(row, totals[segment.rival[row]]);
+        }
+    }
+
+    vector<pair<uint32_t, InteractionTotals>> ranked(totals.begin(), totals.end());
+    size_t shown = min(ranked.size(), static_cast<size_t>(count));
+    partial_sort(ranked.begin(), ranked.begin() + static_cast<ptrdiff_t>(shown), ranked.end(),
+                 [](const pair<uint32_t, InteractionTotals>& a, const pair<uint32_t, InteractionTotals>& b) {
+                     if (a.second.hands != b.second.hands) return a.second.hands > b.second.hands;
+                     return a.first < b.first;
+                 });
+    for (size_t i = 0; i < shown; ++i) {
+        rivals.push_back({ names[ranked[i].first], ranked[i].second });
+    }
+    return rivals;
+}
+
+long long InteractionStore::hands() const {
+    lock_guard<mutex> guard(lock);
+    return segmentFiles.empty() ? 0 : static_cast<long long>(segmentFiles.back()->header->lastHand);
+}
+
+int InteractionStore::segments() const {
+    lock_guard<mutex> guard(lock);
+    return static_cast<int>(segmentFiles.size());
+}
+
+int InteractionStore::players() const {
+    lock_guard<mutex> guard(lock);
+    return static_cast<int>(names.size());
+}
+
+} // namespace poker
@@ -0,0 +1,76 @@
+#include "poker/player.h"
+
+#include <algorithm>
+#include <iostream>
+
+#include "poker/equity.h"
+#include "poker/equity_cache.h"
+#include "poker/hand_evaluator.h"
+#include "poker/preflop.h"
+
+using namespace std;
+
+namespace poker {
+
+void Player::showHand(bool hideCards) {
+    if (hideCards) {
+        cout << name << "'s hand: [Hidden]" << endl;
+    }
+    else {
+        cout << name << "'s hand: ";
+        for (int i = 0; i < 2; ++i) {
+            cout << hand[i].rank() << " of " << hand[i].suit() << (i == 1 ? "" : ", ");
+        }
+        cout << endl;
+    }
+}
+
+int Player::evaluateHandStrength(const Card communityCards[], int communitySize) {
+    Card cards[7];
+    int numCards = 0;
+    for (int i = 0; i < 2; ++i) {
+        cards[numCards++] = hand[i];
+    }
+    for (int i = 0; i < communitySize && numCards < 7; ++i) {
+        cards[numCards++] = communityCards[i];
+    }
+    return HandEvaluator::instance().evaluate(cards, numCards);
+}
+
+double Player::estimateEquity(const Card communityCards[], int communitySize, int numOpponents, uint64_t seed) {
+    if (numOpponents < 1) return 1.0;
+    numOpponents = min(numOpponents, MAX_PLAYERS - 1);
+
+    // Before the flop the answer is a lookup when a preflop table is installed
+    const PreflopTable* preflopTable = PreflopTable::installed();
+    if (communitySize == 0 && preflopTable) {
+        return preflopTable->equity(hand[0], hand[1], numOpponents);
+    }
+
+    // Otherwise from the shared cache, which only simulates situations it has not seen
+    EquityCache* equityCache = EquityCache::installed();
+    if (equityCache) {
+        return equityCache->equity(hand, communityCards, communitySize, numOpponents, BOT_EQUITY_TRIALS);
+    }
+
+    Card holeCards[MAX_PLAYERS][2] = { { hand[0], hand[1] } };
+    EquityResult odds = EquityCalculator::monteCarlo(holeCards, numOpponents + 1, communityCards, communitySize,
+                                                     BOT_EQUITY_TRIALS, seed, 1);
+    return odds.equity[0];
+}
+
+double Player::estimateEquity(const Card communityCards[], int communitySize, const Range& opponentRange) {
+    Range mine;
+    mine.add(Range::combo(hand[0], hand[1]));
+    return rangeEquity(mine, opponentRange, communityCards, communitySize).equity;
+}
+
+void Player::displayPlayerStatistics() {
+    cout << "Player Statistics for " << name << ":\n";
+    cout << "Chips: " << chips << endl;
+    cout << "Games Won: " << gamesWon << endl;
+    cout << "Hands Played: " << handsPlayed << endl;
+    cout << "Hands Won: " << handsWon << endl;
+}
+
+} // namespace poker
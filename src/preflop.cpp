@@ -0,0 +1,126 @@
+#include "poker/preflop.h"
+
+#include <atomic>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+
+#include "poker/equity.h"
+#include "poker/file_io.h"
+#include "poker/rng.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define POKER_HAVE_MMAP 1
+#endif
+
+using namespace std;
+
+namespace poker {
+
+namespace {
+
+atomic<const PreflopTable*> installedTable(nullptr);
+
+const size_t TABLE_BYTES = sizeof(float) * PreflopTable::NUM_CLASSES * PreflopTable::MAX_OPPONENTS;
+
+} // namespace
+
+PreflopTable::PreflopTable(const string& path) : data(nullptr), length(0), mapped(false), header(nullptr), table(nullptr) {
+#ifdef POKER_HAVE_MMAP
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw runtime_error("Cannot open " + path + ".");
+    }
+    struct stat info;
+    if (fstat(fd, &info) == 0 && info.st_size > 0) {
+        length = static_cast<size_t>(info.st_size);
+        void* address = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (address != MAP_FAILED) {
+            data = static_cast<const char*>(address);
+            mapped = true;
+        }
+    }
+    close(fd);
+#endif
+    if (!mapped) {
+        ifstream in(path, ios::binary);
+        if (!in) {
+            throw runtime_error("Cannot open " + path + ".");
+        }
+        contents.assign(istreambuf_iterator<char>(in), istreambuf_iterator<char>());
+        data = contents.data();
+        length = contents.size();
+    }
+
+    header = reinterpret_cast<const PreflopHeader*>(data);
+    if (length != sizeof(PreflopHeader) + TABLE_BYTES || memcmp(header->magic, PREFLOP_MAGIC, 4) != 0 ||
+        header->version != PREFLOP_VERSION || header->numClasses != NUM_CLASSES || header->maxOpponents != MAX_OPPONENTS) {
+        release();
+        throw runtime_error(path + " is not a version " + to_string(PREFLOP_VERSION) + " preflop equity table.");
+    }
+    table = reinterpret_cast<const float*>(data + sizeof(PreflopHeader));
+}
+
+PreflopTable::~PreflopTable() {
+    release();
+}
+
+void PreflopTable::release() {
+#ifdef POKER_HAVE_MMAP
+    if (mapped) {
+        munmap(const_cast<char*>(data), length);
+        mapped = false;
+    }
+#endif
+}
+
+string PreflopTable::className(int handClass) {
+    int row = handClass / 13;
+    int column = handClass % 13;
+    string name = { RANK_CHARS[row > column ? row : column], RANK_CHARS[row > column ? column : row] };
+    if (row > column) return name + "s";
+    if (row < column) return name + "o";
+    return name;
+}
+
+void PreflopTable::build(const string& path, long long trials, uint64_t seed, int numThreads) {
+    float equities[NUM_CLASSES][MAX_OPPONENTS];
+    for (int handClass = 0; handClass < NUM_CLASSES; ++handClass) {
+        // Any hand of the class will do; against random hands only the ranks and suitedness matter
+        int row = handClass / 13;
+        int column = handClass % 13;
+        bool suited = row > column;
+        Card holeCards[MAX_PLAYERS][2] = { { Card(row * 4), Card(column * 4 + (suited ? 0 : 1)) } };
+        for (int opponents = 1; opponents <= MAX_OPPONENTS; ++opponents) {
+            EquityResult result = EquityCalculator::monteCarlo(holeCards, opponents + 1, nullptr, 0, trials,
+                                                               Rng::splitMix(seed + static_cast<uint64_t>(handClass * MAX_OPPONENTS + opponents)),
+                                                               numThreads);
+            equities[handClass][opponents - 1] = static_cast<float>(result.equity[0]);
+        }
+    }
+
+    PreflopHeader fileHeader = {};
+    memcpy(fileHeader.magic, PREFLOP_MAGIC, 4);
+    fileHeader.version = PREFLOP_VERSION;
+    fileHeader.numClasses = NUM_CLASSES;
+    fileHeader.maxOpponents = MAX_OPPONENTS;
+    fileHeader.trials = static_cast<uint64_t>(trials);
+
+    // Swapped in whole, so a running game never maps half a file and a crash never leaves an empty one
+    writeFileAtomically(path, { { &fileHeader, sizeof(fileHeader) }, { equities, TABLE_BYTES } });
+}
+
+void PreflopTable::install(const PreflopTable* preflopTable) {
+    installedTable.store(preflopTable);
+}
+
+const PreflopTable* PreflopTable::installed() {
+    return installedTable.load(memory_order_acquire);
+}
+
+} // namespace poker
@@ -0,0 +1,327 @@
+#include "poker/range.h"
+
+#include <algorithm>
+#include <bitset>
+#include <cctype>
+#include <cstring>
+#include <stdexcept>
+
+#include "poker/equity.h"
+#include "poker/hand_evaluator.h"
+#include "poker/rng.h"
+
+using namespace std;
+
+namespace poker {
+
+namespace {
+
+// Struct for the cards of every combination, indexed by combination number
+struct ComboTable {
+    uint8_t cards[Range::NUM_COMBOS][2];
+
+    constexpr ComboTable() : cards() {
+        for (int high = 1; high < MAX_CARDS; ++high) {
+            for (int low = 0; low < high; ++low) {
+                cards[high * (high - 1) / 2 + low][0] = static_cast<uint8_t>(low);
+                cards[high * (high - 1) / 2 + low][1] = static_cast<uint8_t>(high);
+            }
+        }
+    }
+};
+
+constexpr ComboTable COMBOS;
+
+// Returns the rank (0-12) of a rank character, or -1
+int parseRank(char c) {
+    const char* rank = strchr(RANK_CHARS, toupper(static_cast<unsigned char>(c)));
+    return rank == nullptr || *rank == '\0' ? -1 : static_cast<int>(rank - RANK_CHARS);
+}
+
+// Struct for a starting hand class such as "AKs": two ranks and 's', 'o' or 0 for both
+struct HandClass {
+    int high;
+    int low;
+    char kind;
+};
+
+// Function to parse a starting hand class such as "AA", "AKs", "KQo" or "T9"
+HandClass parseClass(const string& text) {
+    HandClass hand = { -1, -1, 0 };
+    if (text.size() == 2 || text.size() == 3) {
+        hand.high = parseRank(text[0]);
+        hand.low = parseRank(text[1]);
+        if (text.size() == 3) hand.kind = static_cast<char>(tolower(static_cast<unsigned char>(text[2])));
+    }
+    if (hand.high < 0 || hand.low < 0 || (hand.kind != 0 && hand.kind != 's' && hand.kind != 'o') ||
+        (hand.high == hand.low && hand.kind != 0)) {
+        throw invalid_argument("Invalid hand in range: " + text);
+    }
+    if (hand.high < hand.low) swap(hand.high, hand.low);
+    return hand;
+}
+
+// Function to add every combination of a starting hand class to a range
+void addClass(Range& range, int high, int low, char kind, float weight) {
+    for (int highSuit = 0; highSuit < 4; ++highSuit) {
+        for (int lowSuit = 0; lowSuit < 4; ++lowSuit) {
+            if (high == low ? lowSuit <= highSuit : (kind == 's' && lowSuit != highSuit) || (kind == 'o' && lowSuit == highSuit)) {
+                continue;
+            }
+            range.add(Range::combo(Card(high * 4 + highSuit), Card(low * 4 + lowSuit)), weight);
+        }
+    }
+}
+
+// Function to add one item of a range, e.g. "TT+", "A5s-A2s" or "AhKh:0.5"
+void addItem(Range& range, string item) {
+    float weight = 1.0f;
+    size_t colon = item.find(':');
+    if (colon != string::npos) {
+        weight = stof(item.substr(colon + 1));
+        item = item.substr(0, colon);
+        if (!(weight > 0 && weight <= 1)) {
+            throw invalid_argument("Range weights must be above 0 and at most 1: " + item);
+        }
+    }
+
+    Card cards[2];
+    if (item.size() == 4 && strchr(SUIT_CHARS, tolower(static_cast<unsigned char>(item[1]))) != nullptr &&
+        parseCards(item, cards, 2) == 2) {
+        if (cards[0] == cards[1]) {
+            throw invalid_argument("Invalid hand in range: " + item);
+        }
+        range.add(Range::combo(cards[0], cards[1]), weight);
+        return;
+    }
+
+    size_t dash = item.find('-');
+    if (dash != string::npos) {
+        HandClass from = parseClass(item.substr(0, dash));
+        HandClass to = parseClass(item.substr(dash + 1));
+        bool pairs = from.high == from.low && to.high == to.low;
+        if (!pairs && (from.high != to.high || from.kind != to.kind || from.high == from.low || to.high == to.low)) {
+            throw invalid_argument("A range needs two pairs or two hands with the same top card: " + item);
+        }
+        int first = pairs ? min(from.high, to.high) : min(from.low, to.low);
+        int last = pairs ? max(from.high, to.high) : max(from.low, to.low);
+        for (int rank = first; rank <= last; ++rank) {
+            addClass(range, pairs ? rank : from.high, rank, from.kind, weight);
+        }
+        return;
+    }
+
+    bool plus = !item.empty() && item.back() == '+';
+    HandClass hand = parseClass(plus ? item.substr(0, item.size() - 1) : item);
+    if (!plus) {
+        addClass(range, hand.high, hand.low, hand.kind, weight);
+    }
+    else if (hand.high == hand.low) {
+        for (int rank = hand.high; rank < 13; ++rank) {
+            addClass(range, rank, rank, 0, weight);
+        }
+    }
+    else {
+        for (int rank = hand.low; rank < hand.high; ++rank) {
+            addClass(range, hand.high, rank, hand.kind, weight);
+        }
+    }
+}
+
+// Struct for a combination that is live on a board, as the river sweep needs it
+struct LiveCombo {
+    int value;
+    float weight;
+    uint16_t combo;
+    uint8_t first;
+    uint8_t second;
+};
+
+// Struct for the weighted pairs of hands counted so far
+struct Tally {
+    double win = 0;
+    double tie = 0;
+    double total = 0;
+};
+
+// Function to score the combinations of a range that are live on a board, weakest first
+//
+// The live combinations are laid out one array per card and scored in one evaluateBatch() call.
+int collectLive(const Range& range, const Card board[5], uint64_t boardMask, LiveCombo live[]) {
+    uint8_t cards[7][Range::NUM_COMBOS];
+    int numLive = 0;
+    for (int combo = 0; combo < Range::NUM_COMBOS; ++combo) {
+        if (!range.contains(combo)) continue;
+        uint8_t first = COMBOS.cards[combo][0];
+        uint8_t second = COMBOS.cards[combo][1];
+        if (((boardMask >> first) & 1) || ((boardMask >> second) & 1)) continue;
+
+        cards[0][numLive] = first;
+        cards[1][numLive] = second;
+        live[numLive++] = { 0, range.weight(combo), static_cast<uint16_t>(combo), first, second };
+    }
+    for (int i = 0; i < 5; ++i) {
+        fill(cards[2 + i], cards[2 + i] + numLive, board[i].code);
+    }
+
+    int values[Range::NUM_COMBOS];
+    const uint8_t* const rows[7] = { cards[0], cards[1], cards[2], cards[3], cards[4], cards[5], cards[6] };
+    HandEvaluator::instance().evaluateBatch(rows, numLive, values);
+    for (int i = 0; i < numLive; ++i) {
+        live[i].value = values[i];
+    }
+    sort(live, live + numLive, [](const LiveCombo& a, const LiveCombo& b) { return a.value < b.value; });
+    return numLive;
+}
+
+// Function to count every pair of hands on a complete board
+//
+// Walks the hero's combinations from weakest to strongest while a pointer into the villain's
+// sorted combinations keeps running totals of the weight below and at the hero's value. The
+// villain combinations sharing a card with the hero's hand are subtracted using the same totals
+// kept per card; the one combination sharing both cards was subtracted twice and is added back.
+void sweepRiver(const Range& hero, const Range& villain, const Card board[5], Tally& tally) {
+    uint64_t boardMask = 0;
+    for (int i = 0; i < 5; ++i) {
+        boardMask |= 1ULL << board[i].code;
+    }
+    LiveCombo heroes[Range::NUM_COMBOS];
+    LiveCombo villains[Range::NUM_COMBOS];
+    int numHeroes = collectLive(hero, board, boardMask, heroes);
+    int numVillains = collectLive(villain, board, boardMask, villains);
+
+    double all = 0, below = 0, atOrBelow = 0;
+    double allByCard[MAX_CARDS] = {}, belowByCard[MAX_CARDS] = {}, atOrBelowByCard[MAX_CARDS] = {};
+    for (int v = 0; v < numVillains; ++v) {
+        all += villains[v].weight;
+        allByCard[villains[v].first] += villains[v].weight;
+        allByCard[villains[v].second] += villains[v].weight;
+    }
+
+    int weaker = 0, notStronger = 0;
+    for (int h = 0; h < numHeroes; ++h) {
+        const LiveCombo& hand = heroes[h];
+        for (; weaker < numVillains && villains[weaker].value < hand.value; ++weaker) {
+            below += villains[weaker].weight;
+            belowByCard[villains[weaker].first] += villains[weaker].weight;
+            belowByCard[villains[weaker].second] += villains[weaker].weight;
+        }
+        for (; notStronger < numVillains && villains[notStronger].value <= hand.value; ++notStronger) {
+            atOrBelow += villains[notStronger].weight;
+            atOrBelowByCard[villains[notStronger].first] += villains[notStronger].weight;
+            atOrBelowByCard[villains[notStronger].second] += villains[notStronger].weight;
+        }
+
+        // The villain holding the hero's exact cards has the same value, so it only sits in the tie totals
+        double same = villain.weight(hand.combo);
+        double wins = below - belowByCard[hand.first] - belowByCard[hand.second];
+        double ties = atOrBelow - atOrBelowByCard[hand.first] - atOrBelowByCard[hand.second] + same - wins;
+        double matched = all - allByCard[hand.first] - allByCard[hand.second] + same;
+        tally.win += hand.weight * wins;
+        tally.tie += hand.weight * ties;
+        tally.total += hand.weight * matched;
+    }
+}
+
+} // namespace
+
+Range::Range() : bits(), weights() {}
+
+Range Range::parse(const string& text) {
+    Range range;
+    size_t start = 0;
+    while (start <= text.size()) {
+        size_t end = text.find(',', start);
+        if (end == string::npos) end = text.size();
+        string item;
+        for (size_t i = start; i < end; ++i) {
+            if (!isspace(static_cast<unsigned char>(text[i]))) item += text[i];
+        }
+        if (!item.empty()) addItem(range, item);
+        start = end + 1;
+    }
+    return range;
+}
+
+Range Range::full() {
+    Range range;
+    for (int combo = 0; combo < NUM_COMBOS; ++combo) {
+        range.add(combo);
+    }
+    return range;
+}
+
+void Range::comboCards(int combo, Card& first, Card& second) {
+    first = Card(COMBOS.cards[combo][0]);
+    second = Card(COMBOS.cards[combo][1]);
+}
+
+void Range::removeCards(const Card cards[], int numCards) {
+    for (int i = 0; i < numCards; ++i) {
+        if (cards[i].empty()) continue;
+        for (int other = 0; other < MAX_CARDS; ++other) {
+            if (other != cards[i].code) remove(combo(cards[i], Card(other)));
+        }
+    }
+}
+
+int Range::size() const {
+    int count = 0;
+    for (uint64_t word : bits) {
+        count += static_cast<int>(bitset<64>(word).count());
+    }
+    return count;
+}
+
+RangeEquityResult rangeEquity(const Range& hero, const Range& villain, const Card communityCards[], int communitySize,
+                              long long maxBoards, uint64_t seed) {
+    if (communitySize < 0 || communitySize > 5) {
+        throw invalid_argument("A board has 0 to 5 cards.");
+    }
+    Card board[5];
+    copy(communityCards, communityCards + communitySize, board);
+    Card rest[MAX_CARDS];
+    int numRest = 0;
+    for (int code = 0; code < MAX_CARDS; ++code) {
+        if (find(board, board + communitySize, Card(code)) == board + communitySize) rest[numRest++] = Card(code);
+    }
+
+    int missing = 5 - communitySize;
+    Tally tally;
+    RangeEquityResult result;
+    if (EquityCalculator::binomial(numRest, missing) <= maxBoards) {
+        // Every completion, in combinatorial order
+        int chosen[5] = { 0, 1, 2, 3, 4 };
+        while (true) {
+            for (int i = 0; i < missing; ++i) board[communitySize + i] = rest[chosen[i]];
+            sweepRiver(hero, villain, board, tally);
+            result.boards++;
+
+            int i = missing - 1;
+            while (i >= 0 && chosen[i] == numRest - missing + i) --i;
+            if (i < 0) break;
+            ++chosen[i];
+            for (int j = i + 1; j < missing; ++j) chosen[j] = chosen[j - 1] + 1;
+        }
+    }
+    else {
+        Rng rng(seed);
+        for (long long b = 0; b < maxBoards; ++b) {
+            for (int i = 0; i < missing; ++i) {
+                swap(rest[i], rest[i + rng.below(static_cast<uint32_t>(numRest - i))]);
+                board[communitySize + i] = rest[i];
+            }
+            sweepRiver(hero, villain, board, tally);
+            result.boards++;
+        }
+    }
+
+    if (tally.total > 0) {
+        result.win = tally.win / tally.total;
+        result.tie = tally.tie / tally.total;
+        result.equity = (tally.win + tally.tie / 2) / tally.total;
+    }
+    return result;
+}
+
+} // namespace poker
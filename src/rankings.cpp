@@ -0,0 +1,262 @@
+#include "poker/rankings.h"
+
+#include <algorithm>
+#include <iostream>
+#include <stdexcept>
+#include <unordered_map>
+#include <utility>
+
+using namespace std;
+
+namespace poker {
+
+void playerStats(Player players[], int numPlayers) {
+    unordered_map<string, pair<int, int>> stats; // Player name -> (Games Won, Chips)
+
+    // Populate the hash table with player statistics
+    for (int i = 0; i < numPlayers; ++i) {
+        stats[players[i].name] = {players[i].gamesWon, players[i].chips};
+    }
+
+    // Display player statistics
+    cout << "\nPlayer Statistics:\n";
+    for (const auto& stat : stats) {
+        cout << stat.first << " -> Games Won: " << stat.second.first << ", Chips: " << stat.second.second << endl;
+    }
+}
+
+void rankPlayers(const Player players[], int numPlayers, int order[]) {
+    if (numPlayers > MAX_PLAYERS) {
+        throw invalid_argument("rankPlayers() ranks at most MAX_PLAYERS players.");
+    }
+
+    // Struct for a seat's sort key
+    struct SeatKey {
+        int chips;
+        int seat;
+    };
+    SeatKey keys[MAX_PLAYERS];
+    for (int i = 0; i < numPlayers; ++i) {
+        keys[i] = { players[i].chips, i };
+    }
+
+    // Insertion sort: stable, and the fastest way to order a handful of keys
+    for (int i = 1; i < numPlayers; ++i) {
+        SeatKey key = keys[i];
+        int j = i - 1;
+        for (; j >= 0 && keys[j].chips < key.chips; --j) {
+            keys[j + 1] = keys[j];
+        }
+        keys[j + 1] = key;
+    }
+    for (int i = 0; i < numPlayers; ++i) {
+        order[i] = keys[i].seat;
+    }
+}
+
+void Leaderboard::update(uint32_t player, long long chips) {
+    int32_t existing = nodeOf(player);
+    if (existing != NONE) {
+        int32_t node = existing;
+        if (nodes[node].chips == chips) return;
+        eraseNode(node);
+        nodes[node].chips = chips;
+        insertNode(node);
+        return;
+    }
+
+    int32_t node;
+    if (!freeNodes.empty()) {
+        node = freeNodes.back();
+        freeNodes.pop_back();
+    }
+    else {
+        node = static_cast<int32_t>(nodes.size());
+        nodes.push_back(Node());
+    }
+    // Priorities come from the id, so the same players always make the same tree
+    nodes[node] = { chips, player, static_cast<uint32_t>(Rng::splitMix(player)), 1, NONE, NONE };
+    mapInsert(player, node);
+    insertNode(node);
+}
+
+void Leaderboard::remove(uint32_t player) {
+    int32_t node = nodeOf(player);
+    if (node == NONE) return;
+    eraseNode(node);
+    mapErase(player);
+    freeNodes.push_back(node);
+}
+
+size_t Leaderboard::rank(uint32_t player) const {
+    int32_t target = nodeOn(player);
+    size_t ahead = 0;
+    int32_t node = root;
+    while (node != target) {
+        if (this->ahead(target, node)) {
+            node = nodes[node].left;
+        }
+        else {
+            ahead += sizeOf(nodes[node].left) + 1;
+            node = nodes[node].right;
+        }
+    }
+    return ahead + sizeOf(nodes[node].left) + 1;
+}
+
+Leaderboard::Entry Leaderboard::at(size_t rank) const {
+    if (rank < 1 || rank > size()) {
+        throw out_of_range("No player has rank " + to_string(rank) + ".");
+    }
+    int32_t node = root;
+    while (true) {
+        size_t left = sizeOf(nodes[node].left);
+        if (rank <= left) {
+            node = nodes[node].left;
+        }
+        else if (rank == left + 1) {
+            return { nodes[node].player, nodes[node].chips };
+        }
+        else {
+            rank -= left + 1;
+            node = nodes[node].right;
+        }
+    }
+}
+
+vector<Leaderboard::Entry> Leaderboard::top(size_t count) const {
+    vector<Entry> entries;
+    entries.reserve(min(count, size()));
+
+    // In-order walk that stops after count players
+    vector<int32_t> path;
+    int32_t node = root;
+    while (entries.size() < count && (node != NONE || !path.empty())) {
+        while (node != NONE) {
+            path.push_back(node);
+            node = nodes[node].left;
+        }
+        node = path.back();
+        path.pop_back();
+        entries.push_back({ nodes[node].player, nodes[node].chips });
+        node = nodes[node].right;
+    }
+    return entries;
+}
+
+void Leaderboard::clear() {
+    nodes.clear();
+    slots.clear();
+    freeNodes.clear();
+    root = NONE;
+}
+
+int32_t Leaderboard::nodeOf(uint32_t player) const {
+    if (slots.empty()) return NONE;
+    for (size_t slot = home(player);; slot = (slot + 1) & (slots.size() - 1)) {
+        if (slots[slot].node == NONE || slots[slot].player == player) return slots[slot].node;
+    }
+}
+
+int32_t Leaderboard::nodeOn(uint32_t player) const {
+    int32_t node = nodeOf(player);
+    if (node == NONE) {
+        throw out_of_range("Player " + to_string(player) + " is not on the leaderboard.");
+    }
+    return node;
+}
+
+void Leaderboard::mapInsert(uint32_t player, int32_t node) {
+    // Keep the table at most half full, so probes stay short
+    if (2 * (size() + 1) > slots.size()) {
+        vector<Slot> old = move(slots);
+        slots.assign(max<size_t>(16, 2 * old.size()), { 0, NONE });
+        for (const Slot& entry : old) {
+            if (entry.node != NONE) mapInsert(entry.player, entry.node);
+        }
+    }
+    size_t slot = home(player);
+    while (slots[slot].node != NONE) slot = (slot + 1) & (slots.size() - 1);
+    slots[slot] = { player, node };
+}
+
+void Leaderboard::mapErase(uint32_t player) {
+    size_t mask = slots.size() - 1;
+    size_t hole = home(player);
+    while (slots[hole].player != player || slots[hole].node == NONE) hole = (hole + 1) & mask;
+
+    // Shift later entries of the probe run back into the hole, so no tombstones are needed
+    for (size_t slot = (hole + 1) & mask; slots[slot].node != NONE; slot = (slot + 1) & mask) {
+        size_t want = home(slots[slot].player);
+        if (((slot - want) & mask) >= ((slot - hole) & mask)) {
+            slots[hole] = slots[slot];
+            hole = slot;
+        }
+    }
+    slots[hole].node = NONE;
+}
+
+// Splits a subtree into the nodes ranked ahead of key and the rest
+void Leaderboard::split(int32_t node, int32_t key, int32_t& before, int32_t& rest) {
+    if (node == NONE) {
+        before = rest = NONE;
+        return;
+    }
+    if (ahead(node, key)) {
+        split(nodes[node].right, key, nodes[node].right, rest);
+        before = node;
+    }
+    else {
+        split(nodes[node].left, key, before, nodes[node].left);
+        rest = node;
+    }
+    pull(node);
+}
+
+// Joins two subtrees, every node of before ranking ahead of every node of after
+int32_t Leaderboard::join(int32_t before, int32_t after) {
+    if (before == NONE) return after;
+    if (after == NONE) return before;
+    if (nodes[before].priority > nodes[after].priority) {
+        nodes[before].right = join(nodes[before].right, after);
+        pull(before);
+        return before;
+    }
+    nodes[after].left = join(before, nodes[after].left);
+    pull(after);
+    return after;
+}
+
+void Leaderboard::insertNode(int32_t node) {
+    nodes[node].left = nodes[node].right = NONE;
+    nodes[node].size = 1;
+    int32_t before, rest;
+    split(root, node, before, rest);
+    root = join(join(before, node), rest);
+}
+
+void Leaderboard::eraseNode(int32_t node) {
+    // The node is the first of the rest, so it is the leftmost node there
+    int32_t before, rest;
+    split(root, node, before, rest);
+    int32_t parent = NONE;
+    for (int32_t current = rest; current != node; current = nodes[current].left) {
+        nodes[current].size--;
+        parent = current;
+    }
+    if (parent == NONE) rest = nodes[node].right;
+    else nodes[parent].left = nodes[node].right;
+    root = join(before, rest);
+}
+
+void displayRankings(const Leaderboard& leaderboard, const Player players[], int numPlayers) {
+    for (const Leaderboard::Entry& entry : leaderboard.top(leaderboard.size())) {
+        for (int i = 0; i < numPlayers; ++i) {
+            if (players[i].id >= 0 && static_cast<uint32_t>(players[i].id) == entry.player) {
+                cout << players[i].name << " -> Chips: " << entry.chips << endl;
+            }
+        }
+    }
+}
+
+} // namespace poker
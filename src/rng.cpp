@@ -0,0 +1,14 @@
+#include "poker/rng.h"
+
+#include <random>
+
+using namespace std;
+
+namespace poker {
+
+uint64_t Rng::randomSeed() {
+    random_device device;
+    return (static_cast<uint64_t>(device()) << 32) ^ device();
+}
+
+} // namespace poker
@@ -0,0 +1,90 @@
+#include "poker/side_pots.h"
+
+#include <algorithm>
+
+using namespace std;
+
+namespace poker {
+
+void SidePots::reset(int numSeats) {
+    seats = numSeats;
+    numPots = 0;
+    fill(&byStreet[0][0], &byStreet[0][0] + 4 * MAX_PLAYERS, 0);
+    fill(byHand, byHand + MAX_PLAYERS, 0);
+}
+
+int SidePots::total() const {
+    int chips = 0;
+    for (int i = 0; i < seats; ++i) {
+        chips += byHand[i];
+    }
+    return chips;
+}
+
+int SidePots::build(const Player players[]) {
+    // The pot levels are the distinct contributions of the players still in the hand, smallest first
+    int levels[MAX_PLAYERS];
+    int numLevels = 0;
+    for (int i = 0; i < seats; ++i) {
+        if (players[i].folded || byHand[i] == 0) continue;
+        int slot = numLevels;
+        while (slot > 0 && levels[slot - 1] > byHand[i]) slot--;
+        if (slot > 0 && levels[slot - 1] == byHand[i]) continue;
+        for (int l = numLevels++; l > slot; --l) levels[l] = levels[l - 1];
+        levels[slot] = byHand[i];
+    }
+
+    numPots = 0;
+    int previous = 0;
+    for (int l = 0; l < numLevels; ++l) {
+        Pot pot = { 0, levels[l], 0, 0, 0 };
+        for (int i = 0; i < seats; ++i) {
+            pot.amount += min(byHand[i], levels[l]) - min(byHand[i], previous);
+            if (byHand[i] > previous) pot.contributors |= 1 << i;
+            if (!players[i].folded && byHand[i] >= levels[l]) {
+                pot.eligible |= 1 << i;
+            }
+        }
+        pots[numPots++] = pot;
+        previous = levels[l];
+    }
+
+    // Chips folded players put in above every live player's contribution go to the last pot
+    if (numPots > 0) {
+        for (int i = 0; i < seats; ++i) {
+            pots[numPots - 1].amount += max(0, byHand[i] - previous);
+        }
+    }
+    return numPots;
+}
+
+void SidePots::award(const int scores[], int button, int payouts[]) {
+    fill(payouts, payouts + seats, 0);
+    for (int p = 0; p < numPots; ++p) {
+        Pot& pot = pots[p];
+        int best = -1;
+        for (int i = 0; i < seats; ++i) {
+            if ((pot.eligible >> i & 1) && scores[i] > best) best = scores[i];
+        }
+
+        // Seats in order from the left of the button, so the odd chips go to the earliest winners
+        int winners[MAX_PLAYERS];
+        int numWinners = 0;
+        for (int i = 1; i <= seats; ++i) {
+            int seat = (button + i) % seats;
+            if ((pot.eligible >> seat & 1) && scores[seat] == best) {
+                winners[numWinners++] = seat;
+                pot.winners |= 1 << seat;
+            }
+        }
+        if (numWinners == 0) continue;
+
+        int share = pot.amount / numWinners;
+        int oddChips = pot.amount % numWinners;
+        for (int w = 0; w < numWinners; ++w) {
+            payouts[winners[w]] += share + (w < oddChips ? 1 : 0);
+        }
+    }
+}
+
+} // namespace poker
@@ -0,0 +1,170 @@
+#include "poker/simulation.h"
+
+#include <algorithm>
+#include <chrono>
+#include <stdexcept>
+#include <string>
+
+#include "poker/hand_evaluator.h"
+
+using namespace std;
+
+namespace poker {
+
+ThreadPool::ThreadPool(int numThreads) : stopping(false), queued(0), pending(0), nextQueue(0) {
+    if (numThreads <= 0) numThreads = max(1u, thread::hardware_concurrency());
+    for (int i = 0; i < numThreads; ++i) {
+        queues.push_back(make_unique<WorkQueue>());
+    }
+    for (int i = 0; i < numThreads; ++i) {
+        workers.emplace_back(&ThreadPool::workerLoop, this, i);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        lock_guard<mutex> lock(sleepLock);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (thread& worker : workers) {
+        worker.join();
+    }
+}
+
+void ThreadPool::submit(function<void()> task) {
+    pending++;
+    WorkQueue& target = *queues[nextQueue++ % queues.size()];
+    {
+        lock_guard<mutex> lock(target.lock);
+        target.tasks.push_back(move(task));
+    }
+    {
+        lock_guard<mutex> lock(sleepLock);
+        queued++;
+    }
+    wake.notify_one();
+}
+
+void ThreadPool::wait() {
+    unique_lock<mutex> lock(sleepLock);
+    idle.wait(lock, [this] { return pending == 0; });
+    if (error) {
+        exception_ptr thrown = error;
+        error = nullptr;
+        rethrow_exception(thrown);
+    }
+}
+
+// Function to take a task from the worker's own queue, or steal one from another worker
+bool ThreadPool::takeTask(int self, function<void()>& task) {
+    int numQueues = static_cast<int>(queues.size());
+    for (int i = 0; i < numQueues; ++i) {
+        WorkQueue& queue = *queues[(self + i) % numQueues];
+        lock_guard<mutex> lock(queue.lock);
+        if (queue.tasks.empty()) continue;
+        if (i == 0) {
+            task = move(queue.tasks.back());
+            queue.tasks.pop_back();
+        }
+        else {
+            task = move(queue.tasks.front());
+            queue.tasks.pop_front();
+        }
+        return true;
+    }
+    return false;
+}
+
+void ThreadPool::workerLoop(int self) {
+    for (;;) {
+        {
+            unique_lock<mutex> lock(sleepLock);
+            wake.wait(lock, [this] { return stopping || queued > 0; });
+            if (queued == 0) return;  // Stopping with nothing left to do
+            queued--;
+        }
+
+        // A task was reserved above, so one is waiting in some queue
+        function<void()> task;
+        while (!takeTask(self, task)) {
+            this_thread::yield();
+        }
+        try {
+            task();
+        }
+        catch (...) {
+            lock_guard<mutex> lock(sleepLock);
+            if (!error) error = current_exception();
+        }
+
+        if (--pending == 0) {
+            lock_guard<mutex> lock(sleepLock);
+            idle.notify_all();
+        }
+    }
+}
+
+BatchResult simulateTables(int numTables, int numBots, const GameOptions& options, int numThreads,
+                           InteractionStore* interactionStore) {
+    struct TableResult {
+        long long hands = 0;
+        int chips[MAX_PLAYERS] = {};
+        int handsWon[MAX_PLAYERS] = {};
+    };
+    vector<TableResult> tables(numTables);
+    GameOptions tableOptions = options;
+    tableOptions.headless = true;
+    if (tableOptions.seed == 0) tableOptions.seed = Rng::randomSeed();
+
+    HandEvaluator::instance(); // Build the lookup tables before the workers start
+    auto start = chrono::steady_clock::now();
+    {
+        ThreadPool pool(numThreads);
+        for (int t = 0; t < numTables; ++t) {
+            pool.submit([&tables, &tableOptions, interactionStore, numBots, t] {
+                GameOptions options = tableOptions;
+                options.seed = Rng::splitMix(tableOptions.seed + static_cast<uint64_t>(t) + 1);
+                options.table = static_cast<uint32_t>(t);
+                Deck deck;
+                InterGraph interactions;
+                Player players[MAX_PLAYERS];
+                for (int i = 0; i < numBots; ++i) {
+                    players[i] = Player("Bot " + to_string(i + 1));
+                }
+                TableResult& result = tables[t];
+                try {
+                    result.hands = gameLoop(players, numBots, deck, interactions, options);
+                    if (interactionStore) interactionStore->append(interactions, result.hands);
+                }
+                catch (const exception& e) {
+                    throw runtime_error("Table " + to_string(t) + " (seed " + to_string(options.seed) + ") failed: " + e.what());
+                }
+
+                // Players keep their seats, so seat i is bot i + 1
+                for (int i = 0; i < numBots; ++i) {
+                    result.chips[i] = players[i].chips;
+                    result.handsWon[i] = players[i].handsWon;
+                }
+            });
+        }
+        pool.wait();
+    }
+
+    BatchResult batch;
+    batch.numBots = numBots;
+    batch.tables = numTables;
+    batch.seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    for (const TableResult& table : tables) {
+        batch.hands += table.hands;
+        int leader = static_cast<int>(max_element(table.chips, table.chips + numBots) - table.chips);
+        batch.tablesWon[leader]++;
+        for (int i = 0; i < numBots; ++i) {
+            batch.chips[i] += table.chips[i];
+            batch.handsWon[i] += table.handsWon[i];
+        }
+    }
+    return batch;
+}
+
+} // namespace poker
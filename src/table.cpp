@@ -0,0 +1,349 @@
+#include "poker/table.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+#include "poker/hand_evaluator.h"
+
+using namespace std;
+
+namespace poker {
+
+Table::Table(Deck& deck)
+    : deck(deck), players(nullptr), seats(0), button(0), communitySize(0), toAct(), mayRaise(), dealt(), lastRaise(BIG_BLIND), payouts(),
+      winningSeat(-1), wonPots(0), awarded(0), current() {
+    current.seat = -1;
+}
+
+const Decision& Table::startHand(Player players[], int numPlayers, int button, uint64_t seed) {
+    if (numPlayers < 2 || numPlayers > MAX_PLAYERS) {
+        throw invalid_argument("A hand needs between 2 and MAX_PLAYERS players.");
+    }
+    this->players = players;
+    seats = numPlayers;
+    this->button = button % numPlayers;
+    handRng.seed(seed);
+    deck.shuffle(handRng, 2 * numPlayers + 5);
+    actionLog.clear();
+    communitySize = 0;
+    winningSeat = -1;
+    wonPots = 0;
+    awarded = 0;
+    current = Decision();
+    sidePots.reset(numPlayers);
+    fill(payouts, payouts + MAX_PLAYERS, 0);
+
+    // Deal two cards to each player; players with no chips sit the hand out
+    int funded = 0;
+    for (int i = 0; i < seats; ++i) {
+        players[i].folded = players[i].chips <= 0;
+        dealt[i] = !players[i].folded;
+        players[i].receiveCard(deck.dealCard(), 0);
+        players[i].receiveCard(deck.dealCard(), 1);
+        if (!players[i].folded) funded++;
+    }
+    if (funded < 2) {
+        throw invalid_argument("A hand needs at least two players with chips.");
+    }
+
+    startStreet(PREFLOP);
+
+    // Heads-up the button posts the small blind and acts first before the flop
+    int smallBlind = funded == 2 && !players[this->button].folded ? this->button : nextSeat(this->button);
+    int bigBlind = nextSeat(smallBlind);
+    postBlind(smallBlind, SMALL_BLIND);
+    postBlind(bigBlind, BIG_BLIND);
+
+    advance(bigBlind);
+    return current;
+}
+
+const Decision& Table::apply(const Action& action) {
+    if (handOver()) {
+        throw invalid_argument("The hand is over.");
+    }
+    int seat = current.seat;
+    Player& actor = players[seat];
+
+    switch (action.type) {
+    case ActionType::Fold:
+        actor.folded = true;
+        actionLog.record(seat, ActionType::Fold);
+        break;
+    case ActionType::Check:
+        if (!current.canTake(ActionType::Check)) {
+            throw invalid_argument("Cannot check facing a bet of " + to_string(current.currentBet) + " chips.");
+        }
+        actionLog.record(seat, ActionType::Check);
+        break;
+    case ActionType::Call: {
+        if (!current.canTake(ActionType::Call)) {
+            throw invalid_argument("There is no bet to call.");
+        }
+        int paid = min(current.toCall, actor.chips);
+        actor.chips -= paid;
+        sidePots.contribute(seat, current.street, paid);
+        current.pot += paid;
+        actionLog.record(seat, ActionType::Call, paid);
+        break;
+    }
+    case ActionType::Bet:
+    case ActionType::Raise:
+    case ActionType::Bluff: {
+        // Bets and raises are interchangeable; the log says which one it was
+        if (!current.canTake(ActionType::Bet) && !current.canTake(ActionType::Raise)) {
+            throw invalid_argument("Cannot raise with " + to_string(actor.chips) + " chips behind.");
+        }
+        int target = min(action.amount, current.maxRaise);
+        if (target < min(current.minRaise, current.maxRaise)) {
+            throw invalid_argument("A bet or raise must be to at least " + to_string(current.minRaise) + " chips.");
+        }
+        ActionType logged = action.type == ActionType::Bluff ? ActionType::Bluff
+                          : current.currentBet == 0 ? ActionType::Bet : ActionType::Raise;
+
+        // Only a full raise (or the street's first bet) reopens the betting; an all-in for less
+        // than that only asks the seats that have not matched it to call or fold
+        bool fullRaise = current.currentBet == 0 || target >= current.minRaise;
+        int paid = target - sidePots.contributed(seat, current.street);
+        actor.chips -= paid;
+        sidePots.contribute(seat, current.street, paid);
+        current.pot += paid;
+        if (fullRaise) lastRaise = max(lastRaise, target - current.currentBet);
+        current.currentBet = target;
+        current.raises++;
+        actionLog.record(seat, logged, target);
+
+        for (int i = 0; i < seats; ++i) {
+            if (i == seat || !canBet(i)) {
+                toAct[i] = false;
+            }
+            else if (fullRaise) {
+                toAct[i] = mayRaise[i] = true;
+            }
+            else if (!toAct[i] && sidePots.contributed(i, current.street) < target) {
+                toAct[i] = true;
+                mayRaise[i] = false;
+            }
+        }
+        break;
+    }
+    default:
+        throw invalid_argument("Blinds are posted by the table.");
+    }
+
+    toAct[seat] = false;
+    advance(seat);
+    return current;
+}
+
+int Table::activePlayers() const {
+    int active = 0;
+    for (int i = 0; i < seats; ++i) {
+        if (!players[i].folded) active++;
+    }
+    return active;
+}
+
+// Function to find the next seat after a given one that is still in the hand
+int Table::nextSeat(int seat) const {
+    for (int i = 1; i <= seats; ++i) {
+        int next = (seat + i) % seats;
+        if (!players[next].folded) return next;
+    }
+    return seat;
+}
+
+// Function to check whether a seat can still put chips in
+bool Table::canBet(int seat) const {
+    return !players[seat].folded && players[seat].chips > 0;
+}
+
+void Table::postBlind(int seat, int amount) {
+    int paid = min(amount, players[seat].chips);
+    players[seat].chips -= paid;
+    sidePots.contribute(seat, PREFLOP, paid);
+    current.pot += paid;
+    current.currentBet = max(current.currentBet, sidePots.contributed(seat, PREFLOP));
+    actionLog.record(seat, ActionType::Blind, paid);
+}
+
+// Function to deal a street's cards and open its betting round
+void Table::startStreet(Street street) {
+    current.street = street;
+    actionLog.setStreet(street);
+    int cards = street == FLOP ? 3 : street == PREFLOP ? 0 : 1;
+    for (int i = 0; i < cards && communitySize < 5; ++i) {
+        communityCards[communitySize++] = deck.dealCard();
+    }
+
+    // Nobody bets when at most one player has chips behind
+    int bettors = 0;
+    for (int i = 0; i < seats; ++i) {
+        if (canBet(i)) bettors++;
+    }
+    for (int i = 0; i < seats; ++i) {
+        toAct[i] = bettors > 1 && canBet(i);
+        mayRaise[i] = true;
+    }
+    current.currentBet = 0;
+    current.raises = 0;
+    lastRaise = BIG_BLIND;
+}
+
+// Function to move on to the next decision point after the seat "from" acted
+//
+// Finds the next seat that still has to act; when there is none the street is over, so the
+// next one is dealt and its first seat after the button acts, until the river closes.
+void Table::advance(int from) {
+    for (;;) {
+        if (activePlayers() <= 1) {
+            finishHand();
+            return;
+        }
+        for (int i = 1; i <= seats; ++i) {
+            int seat = (from + i) % seats;
+            if (toAct[seat] && canBet(seat)) {
+                updateDecision(seat);
+                return;
+            }
+        }
+        if (current.street == RIVER) {
+            finishHand();
+            return;
+        }
+        startStreet(static_cast<Street>(current.street + 1));
+        from = button;
+    }
+}
+
+void Table::finishHand() {
+    awarded = current.pot;
+    int scores[MAX_PLAYERS] = {};
+    if (activePlayers() > 1) {
+        // Deal whatever is left of the board and score the hands still in
+        while (communitySize < 5) {
+            communityCards[communitySize++] = deck.dealCard();
+        }
+        for (int i = 0; i < seats; ++i) {
+            if (!players[i].folded) scores[i] = players[i].evaluateHandStrength(communityCards, communitySize);
+        }
+    }
+
+    // With one player left there is a single pot and they are the only one eligible for it
+    sidePots.build(players);
+    sidePots.award(scores, button, payouts);
+
+    // An uncalled bet handed back is not a win, so only pots someone else paid into count
+    wonPots = 0;
+    for (int p = 0; p < sidePots.size(); ++p) {
+        if (sidePots[p].contributors & (sidePots[p].contributors - 1)) wonPots |= sidePots[p].winners;
+    }
+    winningSeat = -1;
+    for (int i = 0; i < seats; ++i) {
+        players[i].chips += payouts[i];
+        if (!won(i)) continue;
+        players[i].gamesWon++;
+        players[i].handsWon++;
+        if (winningSeat < 0 || payouts[i] > payouts[winningSeat]) winningSeat = i;
+    }
+
+    current.pot = 0;
+    current.seat = -1;
+    current.toCall = current.minRaise = current.maxRaise = 0;
+    current.legal = 0;
+}
+
+// Function to fill in the decision point for the seat to act
+void Table::updateDecision(int seat) {
+    const Player& actor = players[seat];
+    current.seat = seat;
+    const int streetBet = sidePots.contributed(seat, current.street);
+    current.toCall = current.currentBet - streetBet;
+    current.minRaise = current.currentBet == 0 ? BIG_BLIND : current.currentBet + lastRaise;
+    current.maxRaise = streetBet + actor.chips;
+
+    uint8_t legal = 1 << static_cast<int>(ActionType::Fold);
+    legal |= 1 << static_cast<int>(current.toCall == 0 ? ActionType::Check : ActionType::Call);
+    if (actor.chips > current.toCall && mayRaise[seat]) {
+        legal |= 1 << static_cast<int>(current.currentBet == 0 ? ActionType::Bet : ActionType::Raise);
+        legal |= 1 << static_cast<int>(ActionType::Bluff);
+    }
+    current.legal = legal;
+}
+
+namespace {
+
+// Hands a bot puts an opponent on at the river: anything, or a narrower range if they bet or raised
+const Range PASSIVE_RANGE = Range::full();
+const Range AGGRESSIVE_RANGE = Range::parse("22+, A2s+, K9s+, Q9s+, J9s+, T9s, 98s, 87s, A9o+, KTo+, QJo");
+
+// Function to estimate the range of the one opponent left in a hand from their bets
+const Range& opponentRange(const Table& table, int seat) {
+    int opponent = -1;
+    for (int i = 0; i < table.numPlayers(); ++i) {
+        if (i != seat && !table.player(i).folded) opponent = i;
+    }
+    const ActionLog& actions = table.actions();
+    for (int i = 0; i < actions.size(); ++i) {
+        ActionType type = actions[i].type;
+        if (actions[i].seat == opponent && (type == ActionType::Bet || type == ActionType::Raise || type == ActionType::Bluff)) {
+            return AGGRESSIVE_RANGE;
+        }
+    }
+    return PASSIVE_RANGE;
+}
+
+} // namespace
+
+Action botAction(Table& table, const Strategy* strategy) {
+    const Decision& decision = table.decision();
+    Player& bot = table.player(decision.seat);
+    int numOpponents = table.activePlayers() - 1;
+
+    // Heads-up on the river the equity is exact, against the range the opponent's betting suggests
+    double equity = numOpponents == 1 && table.boardSize() == 5
+        ? bot.estimateEquity(table.board(), table.boardSize(), opponentRange(table, decision.seat))
+        : bot.estimateEquity(table.board(), table.boardSize(), numOpponents, table.rng().next());
+    ActionType passive = decision.toCall > 0 ? ActionType::Call : ActionType::Check;
+
+    if (strategy) {
+        // Equity against n opponents is roughly the heads-up hand strength to the power n
+        bool canRaise = decision.canTake(ActionType::Bet) || decision.canTake(ActionType::Raise);
+        int bucket = Strategy::bucket(pow(equity, 1.0 / max(1, numOpponents)));
+        int infoSet = Strategy::infoSet(decision.street, decision.raises, decision.toCall > 0, bucket);
+        switch (strategy->choose(infoSet, decision.toCall > 0, canRaise && decision.raises < Strategy::MAX_RAISES, table.rng())) {
+        case CfrAction::Fold:
+            return { ActionType::Fold, 0 };
+        case CfrAction::Raise: {
+            int unit = decision.street >= TURN ? 2 * Table::BIG_BLIND : Table::BIG_BLIND;
+            return { ActionType::Raise, max(decision.minRaise, decision.currentBet + unit) };
+        }
+        default:
+            return { passive, 0 };
+        }
+    }
+
+    // Decision-making based on the made hand and the chances of winning against the players left
+    int strength = bot.evaluateHandStrength(table.board(), table.boardSize());
+    bool strong = HandEvaluator::category(strength) >= THREE_OF_A_KIND || equity >= 1.6 / (numOpponents + 1);
+    int choice = strong ? 0 : static_cast<int>(table.rng().below(4));  // Based on strength, choose action
+
+    bool canRaise = (decision.canTake(ActionType::Bet) || decision.canTake(ActionType::Raise)) && decision.raises < 2;
+    switch (choice) {
+    case 0:
+        // Bet or raise by 50 chips
+        if (canRaise) return { ActionType::Raise, max(decision.minRaise, decision.currentBet + 50) };
+        return { passive, 0 };
+    case 1:
+        return { passive, 0 };
+    case 2:
+        return { decision.toCall > 0 ? ActionType::Fold : ActionType::Check, 0 };
+    default:
+        // Bluff with the smallest raise, keeping some chips back
+        if (canRaise && decision.minRaise < decision.maxRaise) return { ActionType::Bluff, decision.minRaise };
+        return { passive, 0 };
+    }
+}
+
+} // namespace poker
@@ -0,0 +1,1427 @@
+/*
+* Poker Texas Holdem - tests
+*
+* Description :
+    *-Checks the poker engine against slow but obviously correct references:
+    * the hand evaluator against brute force, the batch evaluator against the
+    * scalar one, Monte Carlo and exact equity, the shuffle and seed replay,
+    * the action log, side pots, the hand indexer, range equity, the leaderboard,
+    * trained strategies, the preflop table, the equity cache, the interaction
+    * graph and store, rankings, the saved game and hand history formats, chip
+    * conservation at the table and that headless hands never touch the heap.
+    * Run with no arguments for every test, or a name filter for some of them.
+    *
+     */
+#include <algorithm>
+#include <bitset>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "poker/alloc_hook.h"
+#include "poker/engine.h"
+
+using namespace std;
+using namespace poker;
+
+// Number of failed checks in the test being run
+int checkFailures = 0;
+
+// Function to record the outcome of a check, printing it if it failed
+void check(bool passed, const char* condition, const char* file, int line) {
+    if (passed) return;
+    checkFailures++;
+    if (checkFailures <= 10) {
+        cout << "  " << file << ":" << line << ": CHECK(" << condition << ") failed" << endl;
+    }
+}
+
+#define CHECK(condition) check((condition), #condition, __FILE__, __LINE__)
+
+// Function to check that a piece of work throws a given exception type
+template <typename Exception, typename Function>
+bool throws(Function work) {
+    try {
+        work();
+    }
+    catch (const Exception&) {
+        return true;
+    }
+    return false;
+}
+
+// Function to find a scratch file for a test, removed first if it is left from an earlier run
+string scratchPath(const string& name) {
+    filesystem::path path = filesystem::temp_directory_path() / ("poker_tests_" + name);
+    error_code error;
+    filesystem::remove_all(path, error);
+    return path.string();
+}
+
+// Function to score a five-card hand the slow way
+//
+// Builds the category and the ranks that break ties inside it, most significant first, into one
+// number, so two hands compare as their numbers do and are equal exactly when they tie.
+//
+// Parameters:
+// - const Card cards[5]: The hand.
+//
+// Returns:
+// - long long: The hand's key.
+long long bruteForceKey(const Card cards[5]) {
+    int counts[13] = {};
+    bool flush = true;
+    for (int i = 0; i < 5; ++i) {
+        counts[cards[i].rankIndex()]++;
+        flush = flush && cards[i].suitIndex() == cards[0].suitIndex();
+    }
+
+    // Ranks by how many of each there are, then by rank, highest first
+    int ranks[5];
+    int numRanks = 0;
+    for (int count = 4; count >= 1; --count) {
+        for (int rank = 12; rank >= 0; --rank) {
+            if (counts[rank] == count) ranks[numRanks++] = rank;
+        }
+    }
+
+    int straightHigh = -1;
+    if (numRanks == 5) {
+        if (ranks[0] - ranks[4] == 4) straightHigh = ranks[0];
+        else if (ranks[0] == 12 && ranks[1] == 3) straightHigh = 3; // A-2-3-4-5
+    }
+
+    int category;
+    if (straightHigh >= 0 && flush) category = STRAIGHT_FLUSH;
+    else if (counts[ranks[0]] == 4) category = FOUR_OF_A_KIND;
+    else if (counts[ranks[0]] == 3 && counts[ranks[1]] == 2) category = FULL_HOUSE;
+    else if (flush) category = FLUSH;
+    else if (straightHigh >= 0) category = STRAIGHT;
+    else if (counts[ranks[0]] == 3) category = THREE_OF_A_KIND;
+    else if (counts[ranks[0]] == 2 && counts[ranks[1]] == 2) category = TWO_PAIR;
+    else if (counts[ranks[0]] == 2) category = ONE_PAIR;
+    else category = HIGH_CARD;
+
+    long long key = category;
+    for (int i = 0; i < 5; ++i) {
+        int rank = straightHigh >= 0 ? (i == 0 ? straightHigh : 0) : (i < numRanks ? ranks[i] : 0);
+        key = key * 16 + rank;
+    }
+    return key;
+}
+
+// Every five-card hand against brute force: the same classes, in the same order, 7462 of them
+void testEvaluatorFiveCards() {
+    const HandEvaluator& evaluator = HandEvaluator::instance();
+    unordered_map<long long, int> valueOfKey;
+    bool consistent = true;
+    Card hand[5];
+    for (int a = 0; a < 52; ++a)
+    for (int b = a + 1; b < 52; ++b)
+    for (int c = b + 1; c < 52; ++c)
+    for (int d = c + 1; d < 52; ++d)
+    for (int e = d + 1; e < 52; ++e) {
+        hand[0] = Card(a);
+        hand[1] = Card(b);
+        hand[2] = Card(c);
+        hand[3] = Card(d);
+        hand[4] = Card(e);
+        int value = evaluator.evaluate(hand, 5);
+        auto inserted = valueOfKey.emplace(bruteForceKey(hand), value);
+        consistent = consistent && inserted.first->second == value;
+    }
+    CHECK(consistent);
+    CHECK(valueOfKey.size() == static_cast<size_t>(HandEvaluator::NUM_CLASSES));
+
+    // Ordered by key, the classes must be numbered 1 to 7462 with matching categories
+    map<long long, int> ordered(valueOfKey.begin(), valueOfKey.end());
+    int expected = 1;
+    bool inOrder = true;
+    for (const auto& entry : ordered) {
+        inOrder = inOrder && entry.second == expected++ &&
+                  static_cast<long long>(HandEvaluator::category(entry.second)) == entry.first / (16 * 16 * 16 * 16 * 16);
+    }
+    CHECK(inOrder);
+}
+
+// Six and seven cards score as the best five of them
+void testEvaluatorBestFive() {
+    const HandEvaluator& evaluator = HandEvaluator::instance();
+    Rng rng(11);
+    for (int trial = 0; trial < 20000; ++trial) {
+        Deck deck;
+        deck.shuffle(rng, 7);
+        Card cards[7];
+        for (Card& card : cards) {
+            card = deck.dealCard();
+        }
+        int numCards = 6 + trial % 2;
+        int best = 0;
+        Card five[5];
+        for (int skipped = 0; skipped < (1 << numCards); ++skipped) {
+            if (static_cast<int>(bitset<7>(skipped).count()) != numCards - 5) continue;
+            int n = 0;
+            for (int i = 0; i < numCards; ++i) {
+                if (!(skipped >> i & 1)) five[n++] = cards[i];
+            }
+            best = max(best, evaluator.evaluate(five, 5));
+        }
+        CHECK(evaluator.evaluate(cards, numCards) == best);
+    }
+}
+
+// evaluateBatch(), with AVX2 where the CPU has it, agrees with the scalar path and with evaluate()
+void testBatchEvaluator() {
+    const HandEvaluator& evaluator = HandEvaluator::instance();
+    const int numHands = 10003; // Not a multiple of the vector width, so the tail is covered too
+    vector<uint8_t> columns[7];
+    for (vector<uint8_t>& column : columns) {
+        column.resize(numHands);
+    }
+    Rng rng(12);
+    for (int h = 0; h < numHands; ++h) {
+        Deck deck;
+        deck.shuffle(rng, 7);
+        for (int i = 0; i < 7; ++i) {
+            columns[i][h] = deck.dealCard().code;
+        }
+    }
+    const uint8_t* cards[7];
+    for (int i = 0; i < 7; ++i) {
+        cards[i] = columns[i].data();
+    }
+
+    vector<int> batch(numHands), scalar(numHands);
+    evaluator.evaluateBatch(cards, numHands, batch.data());
+    evaluator.evaluateBatchScalar(cards, numHands, scalar.data());
+    CHECK(batch == scalar);
+    for (int h = 0; h < numHands; h += 97) {
+        Card hand[7];
+        for (int i = 0; i < 7; ++i) {
+            hand[i] = Card(columns[i][h]);
+        }
+        CHECK(scalar[h] == evaluator.evaluate(hand, 7));
+    }
+    cout << "  evaluateBatch " << (HandEvaluator::usesAvx2() ? "used AVX2" : "ran scalar on this CPU") << endl;
+}
+
+// Function to deal hole cards written in short notation, e.g. { "AsAh", "KdKc" }
+void parseHands(const vector<string>& hands, Card holeCards[][2]) {
+    for (size_t p = 0; p < hands.size(); ++p) {
+        parseCards(hands[p], holeCards[p], 2);
+    }
+}
+
+// Function to check that two equity results are the same to the last bit
+bool sameResult(const EquityResult& a, const EquityResult& b, int numPlayers) {
+    bool same = a.trials == b.trials;
+    for (int p = 0; p < numPlayers; ++p) {
+        same = same && a.win[p] == b.win[p] && a.tie[p] == b.tie[p] && a.equity[p] == b.equity[p];
+    }
+    return same;
+}
+
+// Monte Carlo equity: a seed gives one answer whatever the thread count, close to the known one
+void testMonteCarloEquity() {
+    Card holeCards[MAX_PLAYERS][2];
+    parseHands({ "AsAh", "KdKc" }, holeCards);
+    // A partial last chunk, so the split of trials into chunks is covered too
+    long long trials = 12 * EquityCalculator::CHUNK_TRIALS + 123;
+    EquityResult single = EquityCalculator::monteCarlo(holeCards, 2, nullptr, 0, trials, 42, 1);
+    CHECK(single.trials == trials);
+    CHECK(sameResult(single, EquityCalculator::monteCarlo(holeCards, 2, nullptr, 0, trials, 42, 1), 2));
+    CHECK(sameResult(single, EquityCalculator::monteCarlo(holeCards, 2, nullptr, 0, trials, 42, 3), 2));
+    CHECK(sameResult(single, EquityCalculator::monteCarlo(holeCards, 2, nullptr, 0, trials, 42, 8), 2));
+    CHECK(!sameResult(single, EquityCalculator::monteCarlo(holeCards, 2, nullptr, 0, trials, 43, 1), 2));
+
+    // Aces against kings preflop are about 82%, and the shares add up to the whole pot
+    CHECK(fabs(single.equity[0] - 0.82) < 0.01);
+    CHECK(fabs(single.equity[0] + single.equity[1] - 1) < 1e-9);
+    CHECK(fabs(single.win[0] + single.win[1] + single.tie[0] - 1) < 1e-9);
+
+    // An unknown hand is dealt at random: aces win about 85% against one random hand
+    parseHands({ "AsAh", "????" }, holeCards);
+    EquityResult random = EquityCalculator::monteCarlo(holeCards, 2, nullptr, 0, trials, 42, 0);
+    CHECK(fabs(random.equity[0] - 0.852) < 0.01);
+}
+
+// Exact equity: river and turn spots worked out by hand, a flop that agrees with sampling
+void testExactEquity() {
+    Card holeCards[MAX_PLAYERS][2];
+    Card board[5];
+
+    // River: aces beat kings on a dry board, and a straight on the board that neither can beat is a split
+    parseHands({ "AsAh", "KdKc" }, holeCards);
+    parseCards("2c7d9hJs3c", board, 5);
+    EquityResult result = EquityCalculator::enumerate(holeCards, 2, board, 5, 1);
+    CHECK(result.trials == 1 && result.win[0] == 1 && result.win[1] == 0 && result.equity[0] == 1);
+    parseCards("5d6c7s8h9d", board, 5);
+    result = EquityCalculator::enumerate(holeCards, 2, board, 5, 1);
+    CHECK(result.tie[0] == 1 && result.tie[1] == 1 && result.equity[0] == 0.5 && result.equity[1] == 0.5);
+
+    // Turn: kings have a set, and only the two aces left among the 44 rivers save the aces
+    parseCards("2c7d9hKs", board, 5);
+    result = EquityCalculator::enumerate(holeCards, 2, board, 4, 1);
+    CHECK(result.trials == 44);
+    CHECK(fabs(result.win[0] - 2.0 / 44) < 1e-12 && fabs(result.win[1] - 42.0 / 44) < 1e-12);
+    CHECK(result.tie[0] == 0);
+
+    // Turn: the same two ranks with no flush possible split on every river
+    parseHands({ "AsKd", "AhKc" }, holeCards);
+    parseCards("2c7d9hQs", board, 5);
+    result = EquityCalculator::enumerate(holeCards, 2, board, 4, 1);
+    CHECK(result.tie[0] == 1 && result.equity[0] == 0.5 && result.equity[1] == 0.5);
+
+    // Flop, three ways: the same on any number of threads, and within noise of sampling
+    parseHands({ "AsKs", "QdQc", "8h7h" }, holeCards);
+    parseCards("Qs9h2s", board, 5);
+    result = EquityCalculator::enumerate(holeCards, 3, board, 3, 1);
+    CHECK(result.trials == EquityCalculator::binomial(43, 2));
+    CHECK(sameResult(result, EquityCalculator::enumerate(holeCards, 3, board, 3, 4), 3));
+    EquityResult sampled = EquityCalculator::monteCarlo(holeCards, 3, board, 3, 400000, 7, 0);
+    for (int p = 0; p < 3; ++p) {
+        CHECK(fabs(result.equity[p] - sampled.equity[p]) < 0.005);
+    }
+
+    // Every hole card must be known
+    parseHands({ "AsKs", "????" }, holeCards);
+    CHECK(throws<invalid_argument>([&] { EquityCalculator::enumerate(holeCards, 2, board, 3, 1); }));
+}
+
+// Function to seat players named P0, P1, ... with starting chips, the listed seats folded
+void seatPlayers(Player players[], int numPlayers, uint8_t folded) {
+    for (int i = 0; i < numPlayers; ++i) {
+        players[i] = Player("P" + to_string(i));
+        players[i].folded = (folded >> i & 1) != 0;
+    }
+}
+
+// Partial shuffle: the dealt cards are uniform, the deck stays a permutation and a seed repeats it
+void testDeckPartialShuffle() {
+    Deck deck;
+    Rng rng(7);
+    const int draws = 52000;
+    int firstCard[MAX_CARDS] = {};
+    int lastDealt[MAX_CARDS] = {};
+    for (int draw = 0; draw < draws; ++draw) {
+        deck.shuffle(rng, 9);
+        bitset<MAX_CARDS> seen;
+        for (const Card& card : deck.cards) {
+            seen.set(card.code);
+        }
+        CHECK(seen.all() && deck.topCardIndex == 0);
+        firstCard[deck.cards[0].code]++;
+        lastDealt[deck.cards[8].code]++;
+    }
+    // Each card should come up about 1000 times in either position; 5 standard deviations is ~160
+    for (int card = 0; card < MAX_CARDS; ++card) {
+        CHECK(abs(firstCard[card] - draws / MAX_CARDS) < 160);
+        CHECK(abs(lastDealt[card] - draws / MAX_CARDS) < 160);
+    }
+
+    Rng first(99), second(99);
+    Deck other;
+    deck.shuffle(first, 9);
+    other.shuffle(second, 9);
+    CHECK(memcmp(deck.cards, other.cards, sizeof(deck.cards)) == 0);
+    for (int i = 0; i < 9; ++i) {
+        CHECK(deck.dealCard() == other.dealCard());
+    }
+}
+
+// Function to play a headless session of bots and return a digest of where the chips ended up
+uint64_t playSession(uint64_t seed, long long hands, Player players[]) {
+    GameOptions options;
+    options.headless = true;
+    options.seed = seed;
+    options.maxHands = hands;
+    Deck deck;
+    InterGraph interactions;
+    for (int i = 0; i < MAX_PLAYERS; ++i) {
+        players[i] = Player("Bot " + to_string(i + 1));
+    }
+    CHECK(gameLoop(players, MAX_PLAYERS, deck, interactions, options) > 0);
+    uint64_t digest = 0;
+    for (int i = 0; i < MAX_PLAYERS; ++i) {
+        digest = Rng::splitMix(digest ^ static_cast<uint64_t>(players[i].chips) ^ static_cast<uint64_t>(players[i].handsWon) << 32);
+    }
+    return digest;
+}
+
+// Seed replay: a session seed replays the same deals and bot decisions, and a hand's deal depends only on its seed
+void testSeedReplay() {
+    Player first[MAX_PLAYERS], second[MAX_PLAYERS];
+    uint64_t digest = playSession(12345, 300, first);
+    CHECK(playSession(12345, 300, second) == digest);
+    for (int i = 0; i < MAX_PLAYERS; ++i) {
+        CHECK(first[i].chips == second[i].chips && first[i].handsPlayed == second[i].handsPlayed);
+    }
+    CHECK(playSession(54321, 300, second) != digest);
+
+    // The same hand seed deals the same cards, whatever was dealt before
+    Deck deck;
+    Table table(deck);
+    seatPlayers(first, 4, 0);
+    table.startHand(first, 4, 0, 777);
+    Card dealt[4][2];
+    for (int i = 0; i < 4; ++i) {
+        dealt[i][0] = first[i].hand[0];
+        dealt[i][1] = first[i].hand[1];
+    }
+    seatPlayers(first, 4, 0);
+    table.startHand(first, 4, 0, 778);
+    seatPlayers(first, 4, 0);
+    table.startHand(first, 4, 0, 777);
+    for (int i = 0; i < 4; ++i) {
+        CHECK(first[i].hand[0] == dealt[i][0] && first[i].hand[1] == dealt[i][1]);
+    }
+}
+
+// Action log: records in order with the street stamped on, renders text only when asked, and clears
+void testActionLog() {
+    ActionLog actions;
+    actions.record(0, ActionType::Blind, 10);
+    actions.record(1, ActionType::Blind, 20);
+    actions.record(2, ActionType::Raise, 60);
+    actions.setStreet(FLOP);
+    actions.record(0, ActionType::Check);
+    actions.record(1, ActionType::Bet, 40);
+    actions.record(0, ActionType::Fold);
+    CHECK(actions.size() == 6);
+    CHECK(actions[0].seat == 0 && actions[0].street == PREFLOP && actions[0].type == ActionType::Blind && actions[0].amount == 10);
+    CHECK(actions[2].type == ActionType::Raise && actions[2].amount == 60);
+    CHECK(actions[3].street == FLOP && actions[3].type == ActionType::Check && actions[3].amount == 0);
+    CHECK(actions[5].seat == 0 && actions[5].type == ActionType::Fold);
+    CHECK(ActionLog::describe(actions[1], "Bot 2") == "Bot 2 posts a blind of 20 chips.");
+    CHECK(ActionLog::describe(actions[2], "Ann") == "Ann raises to 60 chips.");
+    CHECK(ActionLog::describe(actions[4], "Bob") == "Bob bets 40 chips.");
+    CHECK(ActionLog::describe(actions[5], "Ann") == "Ann folds.");
+
+    actions.clear();
+    CHECK(actions.size() == 0);
+    actions.record(3, ActionType::Call, 20);
+    CHECK(actions.size() == 1 && actions[0].street == PREFLOP && actions[0].seat == 3);
+
+    // A hand longer than the fixed buffer keeps every action, oldest first
+    actions.clear();
+    const int LONG_HAND = 3 * ActionLog::CAPACITY + 5;
+    for (int i = 0; i < LONG_HAND; ++i) {
+        actions.record(i % 2, ActionType::Raise, 20 * (i + 1));
+    }
+    bool inOrder = actions.size() == LONG_HAND;
+    for (int i = 0; inOrder && i < LONG_HAND; ++i) {
+        inOrder = actions[i].seat == i % 2 && actions[i].amount == 20 * (i + 1);
+    }
+    CHECK(inOrder);
+    actions.clear();
+    actions.record(1, ActionType::Check);
+    CHECK(actions.size() == 1 && actions[0].seat == 1 && actions[0].type == ActionType::Check);
+
+    // A raising war at the table is logged in full
+    Deck deck;
+    Table table(deck);
+    Player players[2] = { Player("Ann"), Player("Bob") };
+    players[0].chips = players[1].chips = 100000;
+    table.startHand(players, 2, 0, 1);
+    int raises = 0;
+    while (table.decision().minRaise < table.decision().maxRaise) {
+        table.apply({ ActionType::Raise, table.decision().minRaise });
+        raises++;
+    }
+    CHECK(raises > ActionLog::CAPACITY && table.actions().size() == raises + 2);
+    CHECK(table.actions()[0].type == ActionType::Blind && table.actions()[raises + 1].type == ActionType::Raise);
+}
+
+// Side pots: layering by all-in amounts, folded chips, uncalled bets and odd chips
+void testSidePots() {
+    Player players[MAX_PLAYERS];
+    int payouts[MAX_PLAYERS];
+
+    // Seat 1 is all-in for 200, seat 0 bet 500 that nobody could call, seat 2 folded after 50
+    SidePots pots;
+    pots.reset(3);
+    seatPlayers(players, 3, 1 << 2);
+    pots.contribute(0, PREFLOP, 100);
+    pots.contribute(1, PREFLOP, 100);
+    pots.contribute(2, PREFLOP, 50);
+    pots.contribute(0, FLOP, 400);
+    pots.contribute(1, FLOP, 100);
+    CHECK(pots.build(players) == 2);
+    CHECK(pots[0].amount == 450 && pots[0].eligible == 0x3);
+    CHECK(pots[1].amount == 300 && pots[1].eligible == 0x1);
+    CHECK(pots[0].contributors == 0x7 && pots[1].contributors == 0x1);
+    int scores[MAX_PLAYERS] = { 10, 20, 99 };
+    pots.award(scores, 0, payouts);
+    CHECK(payouts[0] == 300 && payouts[1] == 450 && payouts[2] == 0);
+
+    // Three all-ins of different sizes make a main pot and two side pots
+    pots.reset(4);
+    seatPlayers(players, 4, 0);
+    const int stacks[4] = { 100, 300, 600, 600 };
+    for (int i = 0; i < 4; ++i) {
+        pots.contribute(i, PREFLOP, stacks[i]);
+    }
+    CHECK(pots.build(players) == 3);
+    CHECK(pots[0].amount == 400 && pots[1].amount == 600 && pots[2].amount == 600);
+    int shortWins[MAX_PLAYERS] = { 50, 40, 30, 20 };
+    pots.award(shortWins, 3, payouts);
+    CHECK(payouts[0] == 400 && payouts[1] == 600 && payouts[2] == 600 && payouts[3] == 0);
+
+    // A tie splits each pot, the odd chip going to the first winner left of the button
+    pots.reset(3);
+    seatPlayers(players, 3, 1 << 1);
+    pots.contribute(0, PREFLOP, 100);
+    pots.contribute(1, PREFLOP, 1);
+    pots.contribute(2, PREFLOP, 100);
+    CHECK(pots.build(players) == 1 && pots[0].amount == 201);
+    int tied[MAX_PLAYERS] = { 7, 0, 7 };
+    pots.award(tied, 0, payouts);
+    CHECK(payouts[0] == 100 && payouts[2] == 101);
+    pots.award(tied, 2, payouts);
+    CHECK(payouts[0] == 101 && payouts[2] == 100);
+
+    // Chips are conserved whatever the contributions
+    Rng rng(13);
+    for (int trial = 0; trial < 2000; ++trial) {
+        int seats = 2 + static_cast<int>(rng.below(MAX_PLAYERS - 1));
+        uint8_t folded = static_cast<uint8_t>(rng.below(1u << seats));
+        if (folded == (1u << seats) - 1) folded &= ~1u;
+        seatPlayers(players, seats, folded);
+        pots.reset(seats);
+        int randomScores[MAX_PLAYERS];
+        for (int i = 0; i < seats; ++i) {
+            pots.contribute(i, static_cast<Street>(rng.below(4)), 1 + static_cast<int>(rng.below(500)));
+            randomScores[i] = static_cast<int>(rng.below(4));
+        }
+        pots.build(players);
+        pots.award(randomScores, static_cast<int>(rng.below(seats)), payouts);
+        int paid = 0;
+        for (int i = 0; i < seats; ++i) {
+            paid += payouts[i];
+            CHECK(payouts[i] == 0 || !players[i].folded);
+        }
+        CHECK(paid == pots.total());
+    }
+}
+
+// The hand indexer: every preflop and flop class unindexes to a hand that indexes back to it
+void testHandIndexer() {
+    const HandIndexer& preflop = HandIndexer::holdem(PREFLOP);
+    const HandIndexer& flop = HandIndexer::holdem(FLOP);
+    CHECK(preflop.size() == 169);
+    CHECK(flop.size() == 1286792);
+
+    Card cards[7];
+    bool roundTrips = true;
+    for (uint64_t index = 0; index < preflop.size(); ++index) {
+        preflop.unindex(preflop.rounds() - 1, index, cards);
+        roundTrips = roundTrips && preflop.index(cards) == index;
+    }
+    for (uint64_t index = 0; index < flop.size(); ++index) {
+        flop.unindex(flop.rounds() - 1, index, cards);
+        roundTrips = roundTrips && flop.index(cards) == index;
+    }
+    CHECK(roundTrips);
+
+    // Renaming suits and reordering cards inside a round keep the index
+    const HandIndexer& river = HandIndexer::holdem(RIVER);
+    Rng rng(14);
+    for (int trial = 0; trial < 20000; ++trial) {
+        Deck deck;
+        deck.shuffle(rng, 7);
+        for (Card& card : cards) {
+            card = deck.dealCard();
+        }
+        int suits[4] = { 0, 1, 2, 3 };
+        shuffle(suits, suits + 4, rng);
+        Card renamed[7];
+        for (int i = 0; i < 7; ++i) {
+            renamed[i] = Card(cards[i].rankIndex() * 4 + suits[cards[i].suitIndex()]);
+        }
+        swap(renamed[0], renamed[1]);
+        reverse(renamed + 2, renamed + 7);
+        uint64_t index = river.index(cards);
+        CHECK(index < river.size());
+        CHECK(river.index(renamed) == index);
+        Card canonical[7];
+        river.unindex(river.rounds() - 1, index, canonical);
+        CHECK(river.index(canonical) == index);
+    }
+
+    Card missing[2] = { Card(0), Card() };
+    CHECK(throws<invalid_argument>([&] { preflop.index(missing); }));
+    Card repeated[2] = { Card(5), Card(5) };
+    CHECK(throws<invalid_argument>([&] { preflop.index(repeated); }));
+}
+
+// Range against range on the river: the sorted sweep matches visiting every pair of hands
+void testRangeRiverSweep() {
+    const HandEvaluator& evaluator = HandEvaluator::instance();
+    Rng rng(15);
+    for (int trial = 0; trial < 6; ++trial) {
+        Deck deck;
+        deck.shuffle(rng, 5);
+        Card board[5];
+        for (Card& card : board) {
+            card = deck.dealCard();
+        }
+
+        // Random weighted ranges, the first trial full against full
+        Range hero = trial == 0 ? Range::full() : Range();
+        Range villain = trial == 0 ? Range::full() : Range();
+        for (int combo = 0; trial > 0 && combo < Range::NUM_COMBOS; ++combo) {
+            if (rng.below(3) == 0) hero.add(combo, 0.25f + static_cast<float>(rng.below(4)) / 4);
+            if (rng.below(3) == 0) villain.add(combo, 0.25f + static_cast<float>(rng.below(4)) / 4);
+        }
+
+        double win = 0, tie = 0, total = 0;
+        for (int h = 0; h < Range::NUM_COMBOS; ++h) {
+            if (!hero.contains(h)) continue;
+            Card h1, h2;
+            Range::comboCards(h, h1, h2);
+            if (find(board, board + 5, h1) != board + 5 || find(board, board + 5, h2) != board + 5) continue;
+            Card heroHand[7] = { h1, h2, board[0], board[1], board[2], board[3], board[4] };
+            int heroScore = evaluator.evaluate(heroHand, 7);
+            for (int v = 0; v < Range::NUM_COMBOS; ++v) {
+                if (!villain.contains(v)) continue;
+                Card v1, v2;
+                Range::comboCards(v, v1, v2);
+                if (v1 == h1 || v1 == h2 || v2 == h1 || v2 == h2) continue;
+                if (find(board, board + 5, v1) != board + 5 || find(board, board + 5, v2) != board + 5) continue;
+                Card villainHand[7] = { v1, v2, board[0], board[1], board[2], board[3], board[4] };
+                int villainScore = evaluator.evaluate(villainHand, 7);
+                double weight = static_cast<double>(hero.weight(h)) * villain.weight(v);
+                total += weight;
+                if (heroScore > villainScore) win += weight;
+                else if (heroScore == villainScore) tie += weight;
+            }
+        }
+
+        RangeEquityResult result = rangeEquity(hero, villain, board, 5);
+        CHECK(total > 0);
+        CHECK(fabs(result.win - win / total) < 1e-9);
+        CHECK(fabs(result.tie - tie / total) < 1e-9);
+        CHECK(fabs(result.equity - (win + tie / 2) / total) < 1e-9);
+    }
+}
+
+// The leaderboard ranks exactly as sorting every player by chips, and ids need not be dense
+void testLeaderboard() {
+    Leaderboard board;
+    map<uint32_t, long long> reference;
+    Rng rng(16);
+    for (int step = 0; step < 100000; ++step) {
+        uint32_t player = static_cast<uint32_t>(rng.below(2000)) * 2000003u; // Spread up to ~4e9
+        if (rng.below(5) == 0) {
+            board.remove(player);
+            reference.erase(player);
+        }
+        else {
+            long long chips = static_cast<long long>(rng.below(300));
+            board.update(player, chips);
+            reference[player] = chips;
+        }
+        if (step % 2500 != 0) continue;
+
+        vector<pair<long long, uint32_t>> sorted;
+        for (const auto& entry : reference) {
+            sorted.push_back({ -entry.second, entry.first });
+        }
+        sort(sorted.begin(), sorted.end());
+        CHECK(board.size() == sorted.size());
+        bool matches = true;
+        for (size_t rank = 1; rank <= sorted.size(); ++rank) {
+            Leaderboard::Entry entry = board.at(rank);
+            matches = matches && entry.player == sorted[rank - 1].second && entry.chips == -sorted[rank - 1].first &&
+                      board.rank(entry.player) == rank && board.contains(entry.player);
+        }
+        CHECK(matches);
+        vector<Leaderboard::Entry> top = board.top(10);
+        CHECK(top.size() == min<size_t>(10, sorted.size()));
+        for (size_t i = 0; i < top.size(); ++i) {
+            CHECK(top[i].player == sorted[i].second);
+        }
+    }
+    CHECK(!board.contains(1));
+    CHECK(throws<out_of_range>([&] { board.at(board.size() + 1); }));
+    CHECK(throws<out_of_range>([&] { board.rank(1); }));
+    CHECK(throws<out_of_range>([&] { board.chips(1); }));
+    board.clear();
+    CHECK(board.size() == 0 && !board.contains(0));
+    CHECK(throws<out_of_range>([&] { board.rank(0); }) && throws<out_of_range>([&] { board.chips(0); }));
+}
+
+// Function to check that two strategies hold the same probabilities to the last bit
+bool sameStrategy(const Strategy& a, const Strategy& b) {
+    return memcmp(a.probabilities(0), b.probabilities(0), sizeof(float) * Strategy::NUM_INFOSETS * Strategy::NUM_ACTIONS) == 0;
+}
+
+// Trained strategies and checkpoints read back exactly, and a resumed run trains as if it never stopped
+void testStrategyRoundTrip() {
+    string strategyPath = scratchPath("strategy.bin");
+    string checkpointPath = scratchPath("checkpoint.bin");
+
+    CfrTrainer first(5);
+    first.train(1800, 1);
+    first.saveCheckpoint(checkpointPath);
+    CfrTrainer resumed(77); // The checkpoint brings its own seed
+    resumed.loadCheckpoint(checkpointPath);
+    CHECK(resumed.iterations() == 1800);
+    CHECK(sameStrategy(resumed.averageStrategy(), first.averageStrategy()));
+
+    // Training on one thread is deterministic, so the resumed trainer keeps step with the original
+    first.train(1200, 1);
+    resumed.train(1200, 1);
+    Strategy expected = first.averageStrategy();
+    CHECK(resumed.iterations() == 3000 && expected.iterations() == 3000);
+    CHECK(sameStrategy(resumed.averageStrategy(), expected));
+    CHECK(!sameStrategy(expected, Strategy()));
+
+    expected.save(strategyPath);
+    Strategy loaded;
+    loaded.load(strategyPath);
+    CHECK(sameStrategy(loaded, expected) && loaded.iterations() == 3000);
+
+    // Damaged, mismatched and missing files are reported, and leave the strategy as it was
+    Strategy untouched;
+    CHECK(throws<runtime_error>([&] { untouched.load(checkpointPath); }));
+    CHECK(throws<runtime_error>([&] { resumed.loadCheckpoint(strategyPath); }));
+    filesystem::resize_file(strategyPath, filesystem::file_size(strategyPath) - 4);
+    CHECK(throws<runtime_error>([&] { untouched.load(strategyPath); }));
+    {
+        FILE* file = fopen(strategyPath.c_str(), "r+b");
+        uint32_t version = STRATEGY_VERSION + 1;
+        fseek(file, 4, SEEK_SET);
+        fwrite(&version, sizeof(version), 1, file);
+        fclose(file);
+    }
+    CHECK(throws<runtime_error>([&] { untouched.load(strategyPath); }));
+    filesystem::remove(strategyPath);
+    CHECK(throws<runtime_error>([&] { untouched.load(strategyPath); }));
+    CHECK(sameStrategy(untouched, Strategy()) && untouched.iterations() == 0);
+    filesystem::remove(checkpointPath);
+}
+
+// Preflop table: a built table reads back, ranks the classes sensibly and rejects damaged files
+void testPreflopTable() {
+    // Every starting hand falls in one of the 169 classes: 6 combos per pair, 4 per suited and 12 per offsuit hand
+    int combos[PreflopTable::NUM_CLASSES] = {};
+    for (int first = 0; first < MAX_CARDS; ++first) {
+        for (int second = first + 1; second < MAX_CARDS; ++second) {
+            int handClass = PreflopTable::handClass(Card(first), Card(second));
+            CHECK(handClass == PreflopTable::handClass(Card(second), Card(first)));
+            combos[handClass]++;
+        }
+    }
+    for (int c = 0; c < PreflopTable::NUM_CLASSES; ++c) {
+        string name = PreflopTable::className(c);
+        CHECK(combos[c] == (name.size() == 2 ? 6 : name[2] == 's' ? 4 : 12));
+    }
+    Card aces[2], sevenDeuce[2], aceKing[2];
+    parseCards("AsAh", aces, 2);
+    parseCards("7d2c", sevenDeuce, 2);
+    parseCards("AhKh", aceKing, 2);
+    CHECK(PreflopTable::className(PreflopTable::handClass(aces[0], aces[1])) == "AA");
+    CHECK(PreflopTable::className(PreflopTable::handClass(sevenDeuce[0], sevenDeuce[1])) == "72o");
+    CHECK(PreflopTable::className(PreflopTable::handClass(aceKing[0], aceKing[1])) == "AKs");
+
+    string path = scratchPath("preflop.bin");
+    PreflopTable::build(path, 4000, 3, 0);
+    {
+        PreflopTable table(path);
+        CHECK(table.trials() == 4000);
+        CHECK(fabs(table.equity(aces[0], aces[1], 1) - 0.852) < 0.03);
+        CHECK(table.equity(aces[0], aces[1], 1) > table.equity(aceKing[0], aceKing[1], 1));
+        CHECK(table.equity(aceKing[0], aceKing[1], 1) > table.equity(sevenDeuce[0], sevenDeuce[1], 1));
+        for (int opponents = 2; opponents <= PreflopTable::MAX_OPPONENTS; ++opponents) {
+            CHECK(table.equity(aces[0], aces[1], opponents) < table.equity(aces[0], aces[1], opponents - 1));
+        }
+    }
+
+    filesystem::resize_file(path, filesystem::file_size(path) - 4);
+    CHECK(throws<runtime_error>([&] { PreflopTable table(path); }));
+    filesystem::remove(path);
+    CHECK(throws<runtime_error>([&] { PreflopTable table(path); }));
+}
+
+// Equity cache: a repeated or suit-isomorphic situation is a hit with the same answer
+void testEquityCache() {
+    EquityCache cache(1024);
+    CHECK(cache.capacity() == 1024);
+    Card hand[2], board[5], isomorphicHand[2], isomorphicBoard[5];
+    parseCards("AsKs", hand, 2);
+    parseCards("Qs9h2s", board, 5);
+    parseCards("AhKh", isomorphicHand, 2); // Spades and hearts swapped
+    parseCards("Qh9s2h", isomorphicBoard, 5);
+
+    double equity = cache.equity(hand, board, 3, 2, 2000);
+    CHECK(cache.hits() == 0 && cache.misses() == 1);
+    CHECK(cache.equity(hand, board, 3, 2, 2000) == equity);
+    CHECK(cache.equity(isomorphicHand, isomorphicBoard, 3, 2, 2000) == equity);
+    CHECK(cache.hits() == 2 && cache.misses() == 1);
+
+    // Close to the equity engine's answer against two random hands
+    Card holeCards[MAX_PLAYERS][2];
+    parseHands({ "AsKs", "????", "????" }, holeCards);
+    EquityResult sampled = EquityCalculator::monteCarlo(holeCards, 3, board, 3, 200000, 5, 0);
+    CHECK(fabs(equity - sampled.equity[0]) < 0.04);
+
+    // Another street or number of opponents is another situation
+    cache.equity(hand, board, 3, 3, 2000);
+    CHECK(cache.misses() == 2);
+
+    // A miss recomputes the same answer, so clearing changes nothing the bots see
+    cache.clear();
+    CHECK(cache.hits() == 0 && cache.misses() == 0);
+    CHECK(cache.equity(hand, board, 3, 2, 2000) == equity);
+    CHECK(cache.misses() == 1);
+
+    CHECK(EquityCache::installed() == nullptr);
+    EquityCache::install(&cache);
+    CHECK(EquityCache::installed() == &cache);
+    EquityCache::install(nullptr);
+}
+
+// Interaction graph: pairs are recorded in both orders, and a session's flows add up to the chips won
+void testInterGraph() {
+    InterGraph graph;
+    graph.setName(0, "Ann");
+    graph.setName(3, "Bob");
+    graph.addHand(0, 3, 1);
+    graph.addInter(0, 3, 50, 1);
+    graph.addInter(3, 0, 20, 2);
+    graph.addFlow(0, 3, 70);
+    graph.addShowdown(0, 3, true, false);
+    graph.addShowdown(3, 0, true, true);
+    const Interaction& edge = graph.between(0, 3);
+    const Interaction& reverse = graph.between(3, 0);
+    CHECK(graph.name(3) == "Bob");
+    CHECK(edge.hands == 1 && reverse.hands == 1);
+    CHECK(edge.count == 2 && reverse.count == 2 && edge.chips == 70 && reverse.chips == 70);
+    CHECK(edge.lastHand == 2 && reverse.lastHand == 2);
+    CHECK(edge.net == 70 && reverse.net == -70);
+    CHECK(edge.showdowns == 2 && edge.showdownWins == 2 && reverse.showdownWins == 1);
+    CHECK(graph.between(0, 1).hands == 0);
+    graph.reset();
+    CHECK(graph.between(0, 3).count == 0 && graph.between(3, 0).net == 0 && graph.name(0).empty());
+
+    // Over a session every pair stays symmetric, and each player's net against the others is the
+    // chips they won or lost, give or take the chip rounded off each flow
+    GameOptions options;
+    options.headless = true;
+    options.seed = 8;
+    options.maxHands = 200;
+    Deck deck;
+    Player players[MAX_PLAYERS];
+    for (int i = 0; i < MAX_PLAYERS; ++i) {
+        players[i] = Player("Bot " + to_string(i + 1));
+    }
+    long long hands = gameLoop(players, MAX_PLAYERS, deck, graph, options);
+    for (int i = 0; i < MAX_PLAYERS; ++i) {
+        int id = players[i].id;
+        CHECK(graph.name(id) == players[i].name);
+        long long net = 0;
+        for (int j = 0; j < MAX_PLAYERS; ++j) {
+            if (j == i) continue;
+            const Interaction& pair = graph.between(id, players[j].id);
+            const Interaction& opposite = graph.between(players[j].id, id);
+            CHECK(pair.hands == opposite.hands && pair.count == opposite.count && pair.chips == opposite.chips);
+            CHECK(pair.net == -opposite.net && pair.showdownWins <= pair.showdowns && pair.hands <= hands);
+            net += pair.net;
+        }
+        CHECK(llabs(net - (players[i].chips - 1000)) <= hands * (MAX_PLAYERS - 1));
+    }
+}
+
+// Ranking: seats in order of chips, ties in seat order, with the players left where they sit
+void testRankPlayers() {
+    Player players[MAX_PLAYERS];
+    Rng rng(24);
+    for (int trial = 0; trial < 2000; ++trial) {
+        int numPlayers = 1 + static_cast<int>(rng.below(MAX_PLAYERS));
+        vector<pair<int, int>> reference;
+        for (int i = 0; i < numPlayers; ++i) {
+            players[i].name = "P" + to_string(i);
+            players[i].chips = static_cast<int>(rng.below(4)) * 100; // Plenty of ties
+            reference.push_back({ -players[i].chips, i });
+        }
+        sort(reference.begin(), reference.end());
+        int order[MAX_PLAYERS];
+        rankPlayers(players, numPlayers, order);
+        for (int i = 0; i < numPlayers; ++i) {
+            CHECK(order[i] == reference[i].second);
+            CHECK(players[i].name == "P" + to_string(i));
+        }
+    }
+    CHECK(throws<invalid_argument>([&] { rankPlayers(players, MAX_PLAYERS + 1, nullptr); }));
+}
+
+// Names of the players in interaction store tests, with a space and a newline among them
+const char* const STORE_NAMES[] = { "Ann", "Bob", "Cy", "Dee", "Ed Lee", "Flo\nGray", "Gus", "Hal" };
+
+// Reference totals of an interaction store, per (player, rival) name
+typedef map<pair<string, string>, InteractionTotals> StoreTotals;
+
+void addTotals(StoreTotals& totals, const StoreTotals& more) {
+    for (const auto& entry : more) {
+        InteractionTotals& sum = totals[entry.first];
+        sum.hands += entry.second.hands;
+        sum.rounds += entry.second.rounds;
+        sum.chips += entry.second.chips;
+        sum.net += entry.second.net;
+        sum.showdowns += entry.second.showdowns;
+        sum.showdownWins += entry.second.showdownWins;
+    }
+}
+
+// Function to fill an interaction graph with a random session and return its totals per pair of names
+StoreTotals sampleSession(Rng& rng, InterGraph& graph) {
+    graph.reset();
+    int picked[8] = { 0, 1, 2, 3, 4, 5, 6, 7 };
+    for (int i = 0; i < MAX_PLAYERS; ++i) {
+        swap(picked[i], picked[i + static_cast<int>(rng.below(8 - i))]);
+        graph.setName(i, STORE_NAMES[picked[i]]);
+    }
+    for (int i = 0; i < MAX_PLAYERS; ++i) {
+        for (int j = i + 1; j < MAX_PLAYERS; ++j) {
+            for (uint32_t h = rng.below(4); h > 0; --h) graph.addHand(i, j, 1);
+            for (uint32_t r = rng.below(3); r > 0; --r) graph.addInter(i, j, 10 * static_cast<int>(r), 1);
+            if (rng.below(2) == 0) graph.addFlow(i, j, 25);
+            if (rng.below(3) == 0) graph.addShowdown(i, j, true, rng.below(2) == 0);
+        }
+    }
+    StoreTotals totals;
+    for (int i = 0; i < MAX_PLAYERS; ++i) {
+        for (int j = 0; j < MAX_PLAYERS; ++j) {
+            const Interaction& edge = graph.between(i, j);
+            if (i == j || (edge.hands == 0 && edge.count == 0)) continue;
+            InteractionTotals& pair = totals[{ graph.name(i), graph.name(j) }];
+            pair.hands = static_cast<uint64_t>(edge.hands);
+            pair.rounds = static_cast<uint64_t>(edge.count);
+            pair.chips = edge.chips;
+            pair.net = edge.net;
+            pair.showdowns = static_cast<uint64_t>(edge.showdowns);
+            pair.showdownWins = static_cast<uint64_t>(edge.showdownWins);
+        }
+    }
+    return totals;
+}
+
+// Function to check every pair of a store against reference totals, and that no other pair has any
+bool storeMatches(const InteractionStore& store, const StoreTotals& expected, long long lastHands = 0) {
+    bool matches = true;
+    for (const char* player : STORE_NAMES) {
+        for (const char* rival : STORE_NAMES) {
+            auto found = expected.find({ player, rival });
+            InteractionTotals want = found == expected.end() ? InteractionTotals() : found->second;
+            InteractionTotals got = store.between(player, rival, lastHands);
+            matches = matches && got.hands == want.hands && got.rounds == want.rounds && got.chips == want.chips &&
+                      got.net == want.net && got.showdowns == want.showdowns && got.showdownWins == want.showdownWins;
+        }
+    }
+    return matches;
+}
+
+// Function to count the files in a directory whose names end with a suffix
+int countFiles(const string& directory, const string& suffix) {
+    int files = 0;
+    for (const filesystem::directory_entry& entry : filesystem::directory_iterator(directory)) {
+        string name = entry.path().filename().string();
+        if (name.size() >= suffix.size() && name.compare(name.size() - suffix.size(), suffix.size(), suffix) == 0) files++;
+    }
+    return files;
+}
+
+// Interaction store: appends, windows, merging and compaction keep the totals, and reopening recovers
+void testInteractionStore() {
+    string directory = scratchPath("interactions");
+    Rng rng(22);
+    InterGraph graph;
+    vector<StoreTotals> sessions;
+    vector<long long> sessionHands;
+    StoreTotals all;
+    auto appendSession = [&](InteractionStore& store) {
+        sessions.push_back(sampleSession(rng, graph));
+        sessionHands.push_back(20 + static_cast<long long>(rng.below(40)));
+        addTotals(all, sessions.back());
+        store.append(graph, sessionHands.back());
+    };
+    // Function to total the sessions, newest first, that hold the last lastHands hands
+    auto lastSessions = [&](long long lastHands) {
+        StoreTotals window;
+        for (size_t s = sessions.size(); s > 0 && lastHands > 0; --s) {
+            addTotals(window, sessions[s - 1]);
+            lastHands -= sessionHands[s - 1];
+        }
+        return window;
+    };
+
+    {
+        InteractionStore store(directory);
+        for (int session = 0; session < 10; ++session) {
+            appendSession(store);
+        }
+        long long hands = 0;
+        for (long long sessionLength : sessionHands) hands += sessionLength;
+        CHECK(store.hands() == hands && store.segments() == 10 && store.players() == 8);
+        CHECK(storeMatches(store, all));
+
+        // Windows take whole segments: the last three sessions, and one hand more takes in a fourth
+        long long lastThree = sessionHands[7] + sessionHands[8] + sessionHands[9];
+        CHECK(storeMatches(store, lastSessions(lastThree), lastThree));
+        CHECK(storeMatches(store, lastSessions(lastThree + 1), lastThree + 1));
+        CHECK(storeMatches(store, all, hands * 2));
+
+        vector<InteractionStore::Rival> rivals = store.topRivals("Ann", 3);
+        CHECK(rivals.size() == 3);
+        for (size_t i = 0; i < rivals.size(); ++i) {
+            CHECK(rivals[i].totals.hands == all[make_pair(string("Ann"), rivals[i].name)].hands);
+            if (i > 0) CHECK(rivals[i].totals.hands <= rivals[i - 1].totals.hands);
+        }
+        CHECK(store.topRivals("Nobody", 3).empty());
+    }
+
+    // Reopened, the store reads the same; past MAX_SEGMENTS appends merge neighbours without losing anything
+    {
+        InteractionStore store(directory);
+        CHECK(store.segments() == 10 && store.players() == 8);
+        CHECK(storeMatches(store, all));
+        for (int session = 0; session < 30; ++session) {
+            appendSession(store);
+        }
+        CHECK(store.segments() == InteractionStore::MAX_SEGMENTS);
+        CHECK(storeMatches(store, all));
+        // A window widened to segment boundaries holds at least the sessions inside it
+        long long lastHands = sessionHands.back() + sessionHands[sessionHands.size() - 2];
+        StoreTotals window = lastSessions(lastHands);
+        for (const auto& entry : window) {
+            CHECK(store.between(entry.first.first, entry.first.second, lastHands).hands >= entry.second.hands);
+        }
+    }
+
+    // An interrupted compaction leaves the merged segment beside the ones it covers, and a stray
+    // temporary file: reopening drops both
+    string backup = scratchPath("interactions_backup");
+    filesystem::create_directories(backup);
+    for (const filesystem::directory_entry& entry : filesystem::directory_iterator(directory)) {
+        filesystem::copy_file(entry.path(), backup / entry.path().filename());
+    }
+    {
+        InteractionStore store(directory);
+        store.compact();
+        CHECK(store.segments() == 1);
+        CHECK(storeMatches(store, all));
+    }
+    for (const filesystem::directory_entry& entry : filesystem::directory_iterator(backup)) {
+        if (entry.path().extension() == ".pkis") filesystem::copy_file(entry.path(), directory / entry.path().filename());
+    }
+    FILE* stray = fopen((filesystem::path(directory) / "segment-99999999.pkis.tmp").string().c_str(), "wb");
+    fputs("half a segment", stray);
+    fclose(stray);
+    CHECK(countFiles(directory, ".pkis") == InteractionStore::MAX_SEGMENTS + 1);
+    {
+        InteractionStore store(directory);
+        CHECK(store.segments() == 1);
+        CHECK(storeMatches(store, all));
+        CHECK(countFiles(directory, ".pkis") == 1 && countFiles(directory, ".tmp") == 0);
+    }
+
+    // A segment that only partly overlaps another is damage, not a leftover
+    string merged;
+    for (const filesystem::directory_entry& entry : filesystem::directory_iterator(directory)) {
+        if (entry.path().extension() == ".pkis") merged = entry.path().string();
+    }
+    string overlapping = (filesystem::path(directory) / "segment-99999998.pkis").string();
+    filesystem::copy_file(merged, overlapping);
+    {
+        FILE* file = fopen(overlapping.c_str(), "r+b");
+        uint64_t firstHand = 2;
+        uint64_t lastHand = static_cast<uint64_t>(1000000);
+        fseek(file, offsetof(InteractionSegmentHeader, firstHand), SEEK_SET);
+        fwrite(&firstHand, sizeof(firstHand), 1, file);
+        fwrite(&lastHand, sizeof(lastHand), 1, file);
+        fclose(file);
+    }
+    CHECK(throws<runtime_error>([&] { InteractionStore store(directory); }));
+    filesystem::remove(overlapping);
+
+    // A name longer than the rest of the dictionary is damage too, rather than a huge allocation
+    string namesPath = (filesystem::path(directory) / "names").string();
+    {
+        FILE* file = fopen(namesPath.c_str(), "ab");
+        uint32_t length = 0xFFFFFFF0u;
+        fwrite(&length, sizeof(length), 1, file);
+        fputs("Ivy", file);
+        fclose(file);
+    }
+    CHECK(throws<runtime_error>([&] { InteractionStore store(directory); }));
+
+    // And so is a segment using a player the dictionary does not name
+    FILE* names = fopen(namesPath.c_str(), "wb");
+    fputs("PKIN", names);
+    fclose(names);
+    CHECK(throws<runtime_error>([&] { InteractionStore store(directory); }));
+
+    filesystem::remove_all(directory);
+    filesystem::remove_all(backup);
+}
+
+// A saved game reads back as it was written, and damage is reported rather than loaded
+void testGameStateRoundTrip() {
+    string path = scratchPath("game_state.bin");
+    Player players[MAX_PLAYERS];
+    for (int i = 0; i < 4; ++i) {
+        players[i] = Player(i == 2 ? "Name with spaces\nand a newline" : "Player " + to_string(i));
+        players[i].chips = 100 * (i + 1);
+        players[i].gamesWon = i;
+        players[i].handsPlayed = 10 + i;
+        players[i].handsWon = 5 + i;
+        players[i].id = 3 - i;
+    }
+    SessionState session;
+    session.seed = 0x123456789ABCDEFULL;
+    session.handsPlayed = 4242;
+    session.button = 2;
+    writeGameState(path, players, 4, session);
+
+    Player loaded[MAX_PLAYERS];
+    int numLoaded = 0;
+    SessionState loadedSession;
+    CHECK(readGameState(path, loaded, numLoaded, loadedSession));
+    CHECK(numLoaded == 4);
+    for (int i = 0; i < 4; ++i) {
+        CHECK(loaded[i].name == players[i].name && loaded[i].chips == players[i].chips &&
+              loaded[i].gamesWon == players[i].gamesWon && loaded[i].handsPlayed == players[i].handsPlayed &&
+              loaded[i].handsWon == players[i].handsWon && loaded[i].id == players[i].id);
+    }
+    CHECK(loadedSession.seed == session.seed && loadedSession.handsPlayed == session.handsPlayed &&
+          loadedSession.button == session.button);
+    CHECK(!filesystem::exists(path + ".tmp"));
+
+    // A flipped byte fails the checksum, a cut file is reported, a missing one is not an error
+    uintmax_t size = filesystem::file_size(path);
+    {
+        FILE* file = fopen(path.c_str(), "r+b");
+        fseek(file, 20, SEEK_SET);
+        int byte = fgetc(file);
+        fseek(file, 20, SEEK_SET);
+        fputc(byte ^ 0xFF, file);
+        fclose(file);
+    }
+    CHECK(throws<runtime_error>([&] { readGameState(path, loaded, numLoaded, loadedSession); }));
+    filesystem::resize_file(path, size - 6);
+    CHECK(throws<runtime_error>([&] { readGameState(path, loaded, numLoaded, loadedSession); }));
+    filesystem::remove(path);
+    CHECK(!readGameState(path, loaded, numLoaded, loadedSession));
+}
+
+// Function to build a hand record whose fields all depend on its number
+HandRecord sampleHand(uint64_t number) {
+    HandRecord hand = {};
+    hand.table = static_cast<uint32_t>(number % 3);
+    hand.handNumber = number;
+    hand.seed = Rng::splitMix(number);
+    hand.pot = static_cast<int32_t>(number * 10);
+    hand.numSeats = 3;
+    hand.boardSize = 5;
+    hand.winner = static_cast<int8_t>(number % 3);
+    for (int i = 0; i < 5; ++i) {
+        hand.board[i] = Card(static_cast<int>((number + i) % 52));
+    }
+    for (int i = 0; i < 3; ++i) {
+        snprintf(hand.names[i], sizeof(hand.names[i]), "Seat %d", i);
+        hand.holeCards[i][0] = Card(static_cast<int>((number + 10 + i) % 52));
+        hand.holeCards[i][1] = Card(static_cast<int>((number + 20 + i) % 52));
+    }
+    return hand;
+}
+
+// Function to build the action log that goes with sampleHand(number)
+void sampleActions(uint64_t number, ActionLog& actions) {
+    actions.clear();
+    actions.record(0, ActionType::Blind, 10);
+    actions.record(1, ActionType::Blind, 20);
+    for (uint64_t i = 0; i < number % 5; ++i) {
+        actions.setStreet(static_cast<Street>(i % 4));
+        actions.record(static_cast<int>(i % 3), ActionType::Raise, static_cast<int>(40 + i));
+    }
+}
+
+// Function to read a hand history back, checking every hand against sampleHand() and counting them
+long long readSampleHistory(const string& path) {
+    HandHistoryReader reader(path);
+    HandHistoryReader::Hand hand;
+    ActionLog expectedActions;
+    long long hands = 0;
+    while (reader.next(hand)) {
+        uint64_t number = hand.record->handNumber;
+        HandRecord expected = sampleHand(number);
+        sampleActions(number, expectedActions);
+        CHECK(number == static_cast<uint64_t>(hands + 1));
+        CHECK(hand.record->seed == expected.seed && hand.record->pot == expected.pot &&
+              hand.record->winner == expected.winner && hand.record->table == expected.table);
+        CHECK(memcmp(hand.record->board, expected.board, sizeof(expected.board)) == 0);
+        CHECK(memcmp(hand.record->holeCards, expected.holeCards, sizeof(expected.holeCards)) == 0);
+        CHECK(string(hand.record->names[2]) == "Seat 2");
+        CHECK(hand.record->numActions == expectedActions.size());
+        for (int i = 0; i < expectedActions.size() && i < hand.record->numActions; ++i) {
+            CHECK(memcmp(&hand.actions[i], &expectedActions[i], sizeof(ActionRecord)) == 0);
+        }
+        hands++;
+    }
+    return hands;
+}
+
+// A hand history reads back as written, and appending after an interrupted run loses nothing
+void testHandHistoryRoundTrip() {
+    string path = scratchPath("history.bin");
+    ActionLog actions;
+    {
+        HandHistoryWriter writer(path);
+        for (uint64_t number = 1; number <= 100; ++number) {
+            sampleActions(number, actions);
+            writer.writeHand(sampleHand(number), actions);
+        }
+        writer.close();
+        CHECK(writer.handsWritten() == 100);
+    }
+    CHECK(readSampleHistory(path) == 100);
+
+    // Cut the last hand short, as a crash would, then append: the partial hand is dropped
+    filesystem::resize_file(path, filesystem::file_size(path) - 50);
+    CHECK(readSampleHistory(path) == 99);
+    {
+        HandHistoryWriter writer(path);
+        for (uint64_t number = 100; number <= 150; ++number) {
+            sampleActions(number, actions);
+            writer.writeHand(sampleHand(number), actions);
+        }
+        writer.close();
+    }
+    CHECK(readSampleHistory(path) == 150);
+
+    FILE* file = fopen(path.c_str(), "wb");
+    fputs("not a hand history", file);
+    fclose(file);
+    CHECK(throws<runtime_error>([&] { HandHistoryWriter writer(path); }));
+    CHECK(throws<runtime_error>([&] { HandHistoryReader reader(path); }));
+    filesystem::remove(path);
+}
+
+// Function to pick a random legal action for the seat to act, sometimes with an odd amount
+Action randomAction(const Decision& decision, Rng& rng) {
+    ActionType legal[8];
+    int numLegal = 0;
+    for (int type = 0; type <= static_cast<int>(ActionType::Bluff); ++type) {
+        if (decision.canTake(static_cast<ActionType>(type))) legal[numLegal++] = static_cast<ActionType>(type);
+    }
+    ActionType type = legal[rng.below(numLegal)];
+    if (type != ActionType::Bet && type != ActionType::Raise && type != ActionType::Bluff) return { type, 0 };
+    int low = min(decision.minRaise, decision.maxRaise);
+    int amount = rng.below(4) == 0 ? decision.maxRaise + 100 : low + static_cast<int>(rng.below(decision.maxRaise - low + 1));
+    return { type, amount };
+}
+
+// Random legal play through Table::apply never creates or loses a chip
+// Test that a bet handed back uncalled does not count as a win
+void testTableWinners() {
+    Deck deck;
+    Table table(deck);
+    Player players[MAX_PLAYERS];
+    bool bigStackWon = false;
+    bool shortStackWon = false;
+    for (uint64_t seed = 0; seed < 40; ++seed) {
+        // The big stack shoves, the short stack calls all-in and 900 chips go back uncalled
+        players[0] = Player("Big");
+        players[0].chips = 1000;
+        players[1] = Player("Short");
+        players[1].chips = 100;
+        table.startHand(players, 2, 0, seed);
+        CHECK(table.decision().seat == 0);
+        table.apply({ ActionType::Raise, 1000 });
+        table.apply({ ActionType::Call, 0 });
+        CHECK(table.handOver());
+        CHECK(table.won(0) == (table.payout(0) > 900));
+        CHECK(table.won(1) == (table.payout(1) > 0));
+        CHECK(players[0].handsWon == (table.won(0) ? 1 : 0) && players[1].handsWon == (table.won(1) ? 1 : 0));
+        bigStackWon = bigStackWon || (table.won(0) && !table.won(1));
+        shortStackWon = shortStackWon || (table.won(1) && !table.won(0));
+    }
+    CHECK(bigStackWon && shortStackWon);
+
+    // Winning the blinds with a raise nobody calls is still a win
+    players[0] = Player("Big");
+    players[0].chips = 1000;
+    players[1] = Player("Short");
+    players[1].chips = 100;
+    table.startHand(players, 2, 0, 1);
+    table.apply({ ActionType::Raise, 60 });
+    table.apply({ ActionType::Fold, 0 });
+    CHECK(table.handOver() && table.payout(0) == 80 && table.winner() == 0);
+    CHECK(table.won(0) && !table.won(1) && players[0].handsWon == 1);
+}
+
+void testTableChipConservation() {
+    Deck deck;
+    Table table(deck);
+    Player players[MAX_PLAYERS];
+    Rng rng(17);
+    long long hands = 0;
+    for (int session = 0; session < 1000; ++session) {
+        int seats = 2 + static_cast<int>(rng.below(MAX_PLAYERS - 1));
+        int total = 0;
+        for (int i = 0; i < seats; ++i) {
+            players[i] = Player("P" + to_string(i));
+            players[i].chips = 1 + static_cast<int>(rng.below(i % 2 == 0 ? 60 : 2000)); // Short stacks go all-in
+            total += players[i].chips;
+        }
+
+        int button = 0;
+        for (int hand = 0; hand < 50; ++hand) {
+            if (count_if(players, players + seats, [](const Player& p) { return p.chips > 0; }) < 2) break;
+            while (players[button].chips <= 0) button = (button + 1) % seats;
+            table.startHand(players, seats, button, rng.next());
+            hands++;
+
+            while (!table.handOver()) {
+                const Decision& decision = table.decision();
+                int inPlay = decision.pot;
+                for (int i = 0; i < seats; ++i) {
+                    inPlay += players[i].chips;
+                }
+                CHECK(inPlay == total);
+
+                // An illegal action is rejected and changes nothing
+                if (decision.toCall > 0) {
+                    int chips = players[decision.seat].chips;
+                    CHECK(throws<invalid_argument>([&] { table.apply({ ActionType::Check, 0 }); }));
+                    CHECK(table.decision().seat == decision.seat && players[decision.seat].chips == chips);
+                }
+                table.apply(randomAction(decision, rng));
+            }
+
+            int stacks = 0;
+            int paid = 0;
+            for (int i = 0; i < seats; ++i) {
+                stacks += players[i].chips;
+                paid += table.payout(i);
+                CHECK(players[i].chips >= 0);
+            }
+            CHECK(stacks == total);
+            CHECK(paid == table.potWon());
+            button = (button + 1) % seats;
+        }
+    }
+    CHECK(hands > 5000);
+}
+
+// Sink for allocated pointers, so the compiler cannot leave out allocations nobody looks at
+void* volatile allocationSink = nullptr;
+
+// Every form of operator new is counted, so the allocation check below cannot miss one
+void testAllocationHook() {
+    long long before = allocationCount();
+    unique_ptr<Deck> deck(new Deck()); // alignas(64), so allocated through the aligned operator new
+    allocationSink = deck.get();
+    unique_ptr<int[]> numbers(new int[16]);
+    allocationSink = numbers.get();
+    unique_ptr<Player> player(new (nothrow) Player());
+    allocationSink = player.get();
+    CHECK(allocationCount() - before == 3);
+    CHECK(reinterpret_cast<uintptr_t>(deck.get()) % alignof(Deck) == 0);
+}
+
+// Headless hands make no heap allocations once the tables are built and the graph is sized
+void testHeadlessHandsAllocationFree() {
+    GameOptions options;
+    options.headless = true;
+    options.seed = 1;
+    Deck deck;
+    InterGraph interactions;
+    Player players[MAX_PLAYERS];
+    for (int i = 0; i < MAX_PLAYERS; ++i) {
+        players[i] = Player("Bot " + to_string(i + 1));
+    }
+
+    // One warm-up hand builds the evaluator tables and names the players in the graph
+    options.maxHands = 1;
+    gameLoop(players, MAX_PLAYERS, deck, interactions, options);
+
+    options.maxHands = 1000;
+    long long before = allocationCount();
+    long long played = gameLoop(players, MAX_PLAYERS, deck, interactions, options);
+    long long allocations = allocationCount() - before;
+    CHECK(played > 100);
+    CHECK(allocations == 0);
+    if (allocations != 0) cout << "  " << allocations << " allocations in " << played << " hands" << endl;
+}
+
+// Struct for a named test
+struct Test {
+    const char* name;
+    function<void()> run;
+};
+
+int main(int argc, char* argv[]) {
+    // An argument runs only the tests whose name contains it
+    string filter = argc > 1 ? argv[1] : "";
+
+    const Test tests[] = {
+        { "evaluator: five cards against brute force", testEvaluatorFiveCards },
+        { "evaluator: six and seven cards are the best five", testEvaluatorBestFive },
+        { "evaluator: batch equals scalar", testBatchEvaluator },
+        { "equity: Monte Carlo is seeded and thread-count independent", testMonteCarloEquity },
+        { "equity: exact enumeration by hand and against sampling", testExactEquity },
+        { "deck: partial shuffle is uniform and seeded", testDeckPartialShuffle },
+        { "seed: a session seed replays the session", testSeedReplay },
+        { "action log: records, describes and clears", testActionLog },
+        { "side pots: build and award", testSidePots },
+        { "hand indexer: index and unindex round trip", testHandIndexer },
+        { "range: river sweep against pairwise", testRangeRiverSweep },
+        { "leaderboard: against a sorted reference", testLeaderboard },
+        { "strategy: save, load and resume from a checkpoint", testStrategyRoundTrip },
+        { "preflop table: build, read back and reject damage", testPreflopTable },
+        { "equity cache: hits for repeated and isomorphic situations", testEquityCache },
+        { "interaction graph: symmetric pairs and flows", testInterGraph },
+        { "rankings: rank players by chips in place", testRankPlayers },
+        { "interaction store: append, windows, merges and recovery", testInteractionStore },
+        { "game state: round trip", testGameStateRoundTrip },
+        { "hand history: round trip", testHandHistoryRoundTrip },
+        { "table: chips are conserved", testTableChipConservation },
+        { "table: uncalled bets are not wins", testTableWinners },
+        { "allocations: every operator new is counted", testAllocationHook },
+        { "allocations: headless hands never allocate", testHeadlessHandsAllocationFree },
+    };
+
+    int run = 0;
+    int failed = 0;
+    for (const Test& test : tests) {
+        if (!filter.empty() && string(test.name).find(filter) == string::npos) continue;
+        checkFailures = 0;
+        auto start = chrono::steady_clock::now();
+        try {
+            test.run();
+        }
+        catch (const exception& e) {
+            cout << "  unexpected exception: " << e.what() << endl;
+            checkFailures++;
+        }
+        double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        cout << (checkFailures == 0 ? "PASS " : "FAIL ") << test.name << " (" << seconds << " s)" << endl;
+        run++;
+        if (checkFailures > 0) failed++;
+    }
+    cout << run - failed << " of " << run << " tests passed" << endl;
+    return run > 0 && failed == 0 ? 0 : 1;
+}